@@ -45,7 +45,9 @@
 
 #include "AdafruitMyPixel.h"
 
+#if defined(__AVR__)
 #include <util/delay.h>
+#endif
 
 // Interrupt is only disabled if there is no PWM device available
 // Note: Adafruit Bluefruit nrf52 does not use this option
@@ -274,81 +276,87 @@ void AdafruitMyPixel::show(void)
     // 20 inst. clocks per bit: HHHHHHxxxxxxxxLLLLLL
     // ST instructions:         ^     ^       ^       (T=0,6,14)
 
+    // Brightness is applied on the fly: each wire byte is run through
+    // FMUL with a 1.7 fixed-point scale (128 = 1.0) in cycles that used
+    // to be padding, so the buffer itself is never rescaled.
+    // NOT YET ASSEMBLED: this loop and its constraints ("+a" for the FMUL
+    // operands, "+e" for port/ptr) have only been checked against the host
+    // model below, never built with avr-gcc for the ATmega168.
     volatile uint8_t next, bbit, tmp, tmp2;	// nächster Wert, akt. Bytebit und Farbbit
+    uint8_t scale = brightness ? (brightness >> 1) : 128;	// Helligkeit 0..128
 
     hi = *port | pinMask;
     lo = *port & ~pinMask;
     // next = lo;
     bbit = 7;
+    b = ((uint16_t)(*ptr & 0xF8) * scale) >> 7;	// erstes Byte skaliert
 
 	asm volatile(
-		"h20farbe1:\n"						// Tkt	Erklärungen			(T =  0)
+		"h20farbe1_%=:\n"					// Tkt	Erklärungen			(T =  0)
 		"st   	%a[port],  %[hisig]\n"		// 2	Port = hi			(T =  2)
 		"mov	%[next], %[losig]\n"		// 1	next = lo			(T =  3)
 		"sbrc	%[byte], 7\n"				// 1-2	if (byte & 0x80)	
 		"mov 	%[next], %[hisig]\n"		// 0-1	next = hi			(T =  5)
 		"dec	%[bit]\n"					// 1	bit--				(T =  6)
 		"st		%a[port], %[next]\n"		// 2	Port = next			(T =  8)
-		"breq	h20farbe1rest\n"			// 1-2	if (bit == 0)
+		"breq	h20farbe1rest_%=\n"			// 1-2	if (bit == 0)
 		"lsl	%[byte]\n"					// 0-1						(T = 10)
 		"rjmp	.+0\n"						// 2	nop,nop				(T = 12)
 		"rjmp	.+0\n"						// 2	nop,nop				(T = 14)
 		"st   	%a[port],  %[losig]\n"		// 2	Port = lo			(T = 16)
 		"rjmp	.+0\n"						// 2	nop,nop				(T = 18)
-		"rjmp	h20farbe1\n"				// 2	-> h20farbe1		(T = 20)
+		"rjmp	h20farbe1_%=\n"				// 2	-> h20farbe1		(T = 20)
 		
-		"h20farbe1rest:\n"					//							(T = 10)
+		"h20farbe1rest_%=:\n"				//							(T = 10)
 		"ld		%[tmp], %a[ptr]+\n"			// 2	tmp = *ptr++		(T = 12)
-		"lsl	%[tmp]\n"					// 1	tmp <<= 1			(T = 13)
+		"swap	%[tmp]\n"					// 1	Nibbles tauschen	(T = 13)
 		"lsl	%[tmp]\n"					// 1	tmp <<= 1			(T = 14)
 		"st   	%a[port],  %[losig]\n"		// 2	Port = lo			(T = 16)
-		"lsl	%[tmp]\n"					// 1	tmp <<= 1			(T = 17)
-		"lsl	%[tmp]\n"					// 1	tmp <<= 1			(T = 18)
-		"ld		%[tmp2], %a[ptr]\n"			// 2	tmp2 = *ptr			(T = 20)
+		"andi	%[tmp], 0xE0\n"			// 1	tmp = *ptr << 5		(T = 17)
+		"ld		%[tmp2], %a[ptr]\n"			// 2	tmp2 = *ptr			(T = 19)
+		"lsr	%[tmp2]\n"					// 1	tmp2 >>= 1			(T = 20)
 		"st   	%a[port],  %[hisig]\n"		// 2	Port = hi			(T =  2)
 		"mov	%[next], %[losig]\n"		// 1	next = lo			(T =  3)
 		"sbrc	%[byte], 6\n"				// 1-2	if (byte & 0x40)	
 		"mov 	%[next], %[hisig]\n"		// 0-1	next = hi			(T =  5)
 		"ldi	%[bit], 7\n"				// 1	bit = 7				(T =  6)
 		"st		%a[port], %[next]\n"		// 2	Port = next			(T =  8)
-		"lsl	%[tmp]\n"					// 1	tmp <<= 1			(T =  9)
+		"lsr	%[tmp2]\n"					// 1	tmp2 >>= 1			(T =  9)
 		"lsr	%[tmp2]\n"					// 1	tmp2 >>= 1			(T = 10)
-		"lsr	%[tmp2]\n"					// 1	tmp2 >>= 1			(T = 11)
-		"lsr	%[tmp2]\n"					// 1	tmp2 >>= 1			(T = 12)
-		"andi	%[tmp2], 0xF8\n"			// 1	tmp2 &= 0xF8		(T = 13)
-		"add	%[tmp], %[tmp2]\n"			// 1	tmp += tmp2			(T = 14)
+		"andi	%[tmp2], 0xF8\n"			// 1	tmp2 &= 0xF8		(T = 11)
+		"add	%[tmp], %[tmp2]\n"			// 1	tmp += tmp2			(T = 12)
+		"fmul	%[tmp], %[scale]\n"		// 2	r1 = tmp * scale	(T = 14)
 		"st   	%a[port],  %[losig]\n"		// 2	Port = lo			(T = 16)
-		"mov	%[byte], %[tmp]\n"			// 1 	byte = tmp			(T = 17)
+		"mov	%[byte], r1\n"				// 1 	byte = r1			(T = 17)
 		"ld		%[tmp], %a[ptr]+\n"			// 2	tmp = *ptr++		(T = 19)
 		"nop\n"								// 1						(T = 20)
 	//	"ld		%[tmp], %[tmp2]\n"			// 1	tmp = tmp2			(T = 14)
 		
-		"h20farbe2:\n"						// 
+		"h20farbe2_%=:\n"					// 
 		"st   	%a[port],  %[hisig]\n"		// 2	Port = hi			(T =  2)
 		"mov	%[next], %[losig]\n"		// 1	next = lo			(T =  3)
 		"sbrc	%[byte], 7\n"				// 1-2	if (byte & 0x80)	
 		"mov 	%[next], %[hisig]\n"		// 0-1	next = hi			(T =  5)
 		"dec	%[bit]\n"					// 1	bit--				(T =  6)
 		"st		%a[port], %[next]\n"		// 2	Port = next			(T =  8)
-		"brmi	h20farbe2rest\n"			// 1-2	if (bit < 0)
+		"brmi	h20farbe2rest_%=\n"			// 1-2	if (bit < 0)
 		"lsl	%[byte]\n"					// 0-1						(T = 10)
 		"rjmp	.+0\n"						// 2	nop,nop				(T = 12)
 		"rjmp	.+0\n"						// 2	nop,nop				(T = 14)
 		"st   	%a[port],  %[losig]\n"		// 2	Port = lo			(T = 16)
 		"rjmp	.+0\n"						// 2	nop,nop				(T = 18)
-		"rjmp	h20farbe2\n"				// 2	-> h20farbe2		(T = 20)
+		"rjmp	h20farbe2_%=\n"				// 2	-> h20farbe2		(T = 20)
 		
-		"h20farbe2rest:\n"					// 							(T = 10)
+		"h20farbe2rest_%=:\n"				// 							(T = 10)
 		"lsl	%[tmp]\n"					// 1	tmp <<= 1			(T = 11)
 		"lsl	%[tmp]\n"					// 1	tmp <<= 1			(T = 12)
-	//	"rjmp	.+0\n"						// 2	nop,nop				(T = 12)
-		"mov	%[byte], %[tmp]\n"			// 1 	byte = tmp			(T = 13)
-		"ldi	%[bit], 7\n"				// 1	bit = 7				(T = 14)
+		"fmul	%[tmp], %[scale]\n"		// 2	r1 = tmp * scale	(T = 14)
 		"st   	%a[port],  %[losig]\n"		// 2	Port = lo			(T = 16)
-		"sbiw 	%[count], 1\n" 				// 2    i--					(T = 18)
-		"rjmp	.+0\n"						// 2	nop,nop				(T = 20)
+		"mov	%[byte], r1\n"				// 1 	byte = r1			(T = 17)
+		"ldi	%[bit], 7\n"				// 1	bit = 7				(T = 18)
+		"sbiw 	%[count], 1\n" 				// 2    i--					(T = 20)
 
-		"h20farbe3:\n"
+		"h20farbe3_%=:\n"
 		"st   	%a[port],  %[hisig]\n"		// 2	Port = hi			(T =  2)
 		"mov	%[next], %[losig]\n"		// 1	next = lo			(T =  3)
 		"sbrc	%[byte], 7\n"				// 1-2	if (byte & 0x80)	
@@ -359,11 +367,11 @@ void AdafruitMyPixel::show(void)
 		"rjmp	.+0\n"						// 2	nop,nop				(T = 12)
 		"rjmp	.+0\n"						// 2	nop,nop				(T = 14)
 		"st   	%a[port],  %[losig]\n"		// 2	Port = lo			(T = 16)
-		"breq	h20farbe3rest\n"			// 1-2	if (bit == 0)
+		"breq	h20farbe3rest_%=\n"			// 1-2	if (bit == 0)
 		"lsl	%[byte]\n"					// 0-1						(T = 18)
-		"rjmp	h20farbe3\n"				// 2	-> h20farbe3		(T = 20)
+		"rjmp	h20farbe3_%=\n"				// 2	-> h20farbe3		(T = 20)
 		
-		"h20farbe3rest:\n"					// 							(T = 18)
+		"h20farbe3rest_%=:\n"				// 							(T = 18)
 		"sbiw 	%[count], 1\n" 				// 2    i--					(T = 20)
 		"st   	%a[port],  %[hisig]\n"		// 2	Port = hi			(T =  2)
 		"mov	%[next], %[losig]\n"		// 1	next = lo			(T =  3)
@@ -371,23 +379,25 @@ void AdafruitMyPixel::show(void)
 		"mov 	%[next], %[hisig]\n"		// 0-1	next = hi			(T =  5)
 		"ldi	%[bit], 7\n"				// 1	bit = 7				(T =  6)
 		"st		%a[port], %[next]\n"		// 2	Port = next			(T =  8)
-		"breq	ende\n"						// 1-2	if (i = 0)
-		"nop\n"								// 0-1						(T = 10)
-		"ld		%[tmp2], %a[ptr]\n"			// 2	tmp2 = *ptr			(T = 12)
-		"andi	%[tmp2], 0xF8\n"			// 1	tmp2 &= 0xF8		(T = 13)
-		"mov	%[byte], %[tmp2]\n"			// 1	byte = tmp2			(T = 14)
+		"breq	ende_%=\n"					// 1-2	if (i = 0)			(T =  9)
+		"ld		%[tmp2], %a[ptr]\n"			// 2	tmp2 = *ptr			(T = 11)
+		"andi	%[tmp2], 0xF8\n"			// 1	tmp2 &= 0xF8		(T = 12)
+		"fmul	%[tmp2], %[scale]\n"		// 2	r1 = tmp2 * scale	(T = 14)
 		"st   	%a[port],  %[losig]\n"		// 2	Port = lo			(T = 16)
-		"rjmp	.+0\n"						// 2	nop,nop				(T = 18)
-		"rjmp	h20farbe1\n"				// 2	-> h20farbe1		(T = 20)
+		"mov	%[byte], r1\n"				// 1	byte = r1			(T = 17)
+		"nop\n"								// 1						(T = 18)
+		"rjmp	h20farbe1_%=\n"				// 2	-> h20farbe1		(T = 20)
 
-		"ende:\n"
+		"ende_%=:\n"
 		"rjmp	.+0\n"						// 2	nop,nop				(T = 12)
 		"rjmp	.+0\n"						// 2	nop,nop				(T = 14)
 		"st   	%a[port],  %[losig]\n"		// 2	Port = lo			(T = 16)
+		"clr	__zero_reg__\n"				// 1	r1 = 0 (von fmul belegt)
 		
-		: [port] "+e"(port), [byte] "+r"(b), [bit] "+r"(bbit),
-		  [next] "+r"(next), [count] "+w"(i), [tmp] "+r"(tmp), [tmp2] "+d"(tmp2)
-		: [ptr] "e"(ptr), [hisig] "r"(hi), [losig] "r"(lo));
+		: [port] "+e"(port), [byte] "+r"(b), [bit] "+d"(bbit),
+		  [next] "+r"(next), [count] "+w"(i), [tmp] "+a"(tmp), [tmp2] "+a"(tmp2),
+		  [ptr] "+e"(ptr)
+		: [hisig] "r"(hi), [losig] "r"(lo), [scale] "a"(scale));
 
 
 #else
@@ -397,6 +407,40 @@ void AdafruitMyPixel::show(void)
   // END AVR ----------------------------------------------------------------
 
 
+#elif defined(MYARDUINO_HOST)
+
+  // Host build (myarduino_host.h) ------------------------------------------
+  // Same wire bytes and the same 20-cycle bit slots as the 16 MHz AVR
+  // code above, written through hostPortWrite() so every edge is recorded
+  // with its cycle time: HIGH at T=2, data bit at T=8, LOW at T=16.
+  // Brightness is applied like the FMUL in the asm: (byte * scale) >> 7.
+
+  uint8_t hi = *port | pinMask;
+  uint8_t lo = *port & ~pinMask;
+  uint8_t *ptr = pixels;
+  uint8_t scale = brightness ? (brightness >> 1) : 128;
+  uint8_t wire[3];
+
+  for (uint16_t n = 0; n < numLEDs; n++, ptr += 2) {
+    wire[0] = ptr[0] & 0xF8;
+    wire[1] = (uint8_t)(ptr[0] << 5) | ((ptr[1] >> 3) & 0xF8);
+    wire[2] = ptr[1] << 2;
+    for (uint8_t k = 0; k < 3; k++) {
+      wire[k] = ((uint16_t)wire[k] * scale) >> 7;
+    }
+    for (uint8_t k = 0; k < 3; k++) {
+      for (uint8_t bit = 0x80; bit; bit >>= 1) {
+        hostTick(2);
+        hostPortWrite(port, hi);
+        hostTick(6);
+        hostPortWrite(port, (wire[k] & bit) ? hi : lo);
+        hostTick(8);
+        hostPortWrite(port, lo);
+        hostTick(4);
+      }
+    }
+  }
+
 #elif defined(__ARDUINO_ARC__)
 
     // Arduino 101  -----------------------------------------------------------
@@ -520,7 +564,7 @@ void AdafruitMyPixel::setPin(int16_t p)
 	//pinMode(pin, INPUT); // Disable existing out pin
 		(pin >= 8 ? DDRB : DDRD) &= ~pinMask;
 		
-#if defined(__AVR__)
+#if defined(__AVR__) || defined(MYARDUINO_HOST)
 	//port = portOutputRegister(digitalPinToPort(p));
 	//pinMask = digitalPinToBitMask(p);
 	port = (p >= 8 ? &PORTB : &PORTD);
@@ -549,11 +593,7 @@ void AdafruitMyPixel::setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b)
 {
   if (n < numLEDs)
   {
-    if (brightness) { // See notes in setBrightness()
-      r = ((uint16_t)r * brightness) >> 8;
-      g = ((uint16_t)g * brightness) >> 8;
-      b = ((uint16_t)b * brightness) >> 8;
-    }
+    // Brightness is applied in show(), see notes in setBrightness()
     uint8_t *p = &pixels[n * 2];
     uint16_t farbe = 0;
     farbe = ((rOffset == 0 ? r : gOffset == 0 ? g : b) & 0xF8) << 8;
@@ -736,10 +776,9 @@ uint32_t AdafruitMyPixel::ColorHSV(uint16_t hue, uint8_t sat, uint8_t val)
   @return  'Packed' 32-bit RGB or WRGB value. Most significant byte is white
            (for RGBW pixels) or 0 (for RGB pixels), next is red, then green,
            and least significant byte is blue.
-  @note    If the strip brightness has been changed from the default value
-           of 255, the color read from a pixel may not exactly match what
-           was previously written with one of the setPixelColor() functions.
-           This gets more pronounced at lower brightness levels.
+  @note    Pixels are stored with 5 bits per color, so the lower 3 bits
+           of each component read back as 0. Brightness does not affect
+           the stored value.
 */
 uint32_t AdafruitMyPixel::getPixelColor(uint16_t n) const
 {
@@ -752,11 +791,6 @@ uint32_t AdafruitMyPixel::getPixelColor(uint16_t n) const
 	uint8_t g = ((p[0] & 0x03) << 6) | ((p[1]& 0xE0) >> 2);
 	uint8_t b = p[1] << 3;
 	
-	if (brightness) {
-		r /= brightness;
-		g /= brightness;
-		b /= brightness;
-	}
 	return ((uint32_t)r << 16)
 		| ((uint32_t)g << 8)
 		| (uint32_t)b;
@@ -767,53 +801,19 @@ uint32_t AdafruitMyPixel::getPixelColor(uint16_t n) const
            currently displayed on the LEDs. The next call to show() will
            refresh the LEDs at this level.
   @param   b  Brightness setting, 0=minimum (off), 255=brightest.
-  @note    This was intended for one-time use in one's setup() function,
-           not as an animation effect in itself. Because of the way this
-           library "pre-multiplies" LED colors in RAM, changing the
-           brightness is often a "lossy" operation -- what you write to
-           pixels isn't necessary the same as what you'll read back.
-           Repeated brightness changes using this function exacerbate the
-           problem. Smart programs therefore treat the strip as a
-           write-only resource, maintaining their own state to render each
-           frame of an animation, not relying on read-modify-write.
+  @note    Brightness is applied by show() while the data is issued, the
+           pixel buffer keeps the unscaled colors. Changing it costs
+           nothing per frame and is not lossy, so it may be used as an
+           animation effect. The scale has 129 steps (b / 2, 255 = 1.0).
 */
 void AdafruitMyPixel::setBrightness(uint8_t b)
 {
   // Stored brightness value is different than what's passed.
-  // This simplifies the actual scaling math later, allowing a fast
-  // 8x8-bit multiply and taking the MSB. 'brightness' is a uint8_t,
-  // adding 1 here may (intentionally) roll over...so 0 = max brightness
-  // (color values are interpreted literally; no scaling), 1 = min
-  // brightness (off), 255 = just below max brightness.
-  uint8_t newBrightness = b + 1;
-  if (newBrightness != brightness) { // Compare against prior value
-    // Brightness has changed -- re-scale existing data in RAM,
-    // This process is potentially "lossy," especially when increasing
-    // brightness. The tight timing in the WS2811/WS2812 code means there
-    // aren't enough free cycles to perform this scaling on the fly as data
-    // is issued. So we make a pass through the existing color data in RAM
-    // and scale it (subsequent graphics commands also work at this
-    // brightness level). If there's a significant step up in brightness,
-    // the limited number of steps (quantization) in the old data will be
-    // quite visible in the re-scaled version. For a non-destructive
-    // change, you'll need to re-render the full strip data. C'est la vie.
-    // TODO: Format umgestellt, Code ist anzupassen
-//    uint8_t c, *ptr = pixels,
-//               oldBrightness = brightness - 1; // De-wrap old brightness value
-//    uint16_t scale;
-//    if (oldBrightness == 0)
-//      scale = 0; // Avoid /0
-//    else if (b == 255)
-//      scale = 65535 / oldBrightness;
-//    else
-//      scale = (((uint16_t)newBrightness << 8) - 1) / oldBrightness;
-//    
-//    for (uint16_t i = 0; i < numBytes; i++) {
-//      c = *ptr;
-//      *ptr++ = (c * scale) >> 8;
-//    }
-    brightness = newBrightness;
-  }
+  // 'brightness' is a uint8_t, adding 1 here may (intentionally) roll
+  // over...so 0 = max brightness (color values are interpreted literally;
+  // no scaling), 1 = min brightness (off), 255 = just below max brightness.
+  // show() turns this into the 1.7 fixed-point factor for FMUL.
+  brightness = b + 1;
 }
 
 /*!
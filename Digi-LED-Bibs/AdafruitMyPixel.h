@@ -37,11 +37,15 @@
 #define ADAFRUITMYPIXEL_H
 
 //#define PROGMEM
-#include <stdint-gcc.h>
 #include <time.h>
+#if defined(__AVR__)
+#include <stdint-gcc.h>
 #include <avr/io.h>
 #include <avr/pgmspace.h>
 #include <avr/interrupt.h>
+#else
+#include "myarduino_host.h" // Host build: simulated PORT/DDR/SREG
+#endif
 
 
 // The order of primary colors in the NeoPixel data stream can vary among
@@ -214,7 +218,7 @@ private:
 	uint8_t wOffset;    ///< Index of white (==rOffset if no white)
 	//uint32_t endTime;   ///< Latch timing reference
 	time_t endTime;   ///< Latch timing reference
-#ifdef __AVR__
+#if defined(__AVR__) || defined(MYARDUINO_HOST)
 	volatile uint8_t *port; ///< Output PORT register
 	uint8_t pinMask;        ///< Output PORT bitmask
 #endif
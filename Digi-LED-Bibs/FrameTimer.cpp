@@ -0,0 +1,256 @@
+/*
+ * FrameTimer.cpp
+ * Bildtakt und Status-LED über Timer1 (siehe FrameTimer.h).
+ * Im Host-Build wird Timer1 aus hostCycles nachgebildet.
+ *
+ * Created: 16.10.2026 21:05:12
+ *  Author: Iggy
+ */
+#include "FrameTimer.h"
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#endif
+
+#define FT_PRESCALE		64UL
+#define FT_TICKS_PER_MS	(F_CPU / FT_PRESCALE / 1000UL)	// 250 bei 16 MHz
+
+volatile uint8_t FrameTimer::_pending = 0;
+volatile uint32_t FrameTimer::_frames = 0;
+volatile uint8_t FrameTimer::_ledLeft = 0;
+uint16_t FrameTimer::_ledPos = 0;
+uint16_t FrameTimer::_overruns = 0;
+uint16_t FrameTimer::_top = 0;
+uint16_t FrameTimer::_lastIdle = 0;
+uint64_t FrameTimer::_idleSum = 0;
+uint32_t FrameTimer::_statStart = 0;
+volatile uint8_t *FrameTimer::_ledPort = 0;
+uint8_t FrameTimer::_ledMask = 0;
+
+// ======================== Timer1 ========================
+#if defined(__AVR__)
+
+ISR(TIMER1_COMPA_vect)
+{
+	FrameTimer::tick();
+}
+
+ISR(TIMER1_COMPB_vect)
+{
+	FrameTimer::ledOff();
+}
+
+static void timerStart(uint16_t top)
+{
+	TCCR1A = 0;
+	TCCR1B = _BV(WGM12) | _BV(CS11) | _BV(CS10);	// CTC bis OCR1A, Vorteiler 64
+	OCR1A = top;
+	TCNT1 = 0;
+	TIFR1 = _BV(OCF1A) | _BV(OCF1B);
+	TIMSK1 = _BV(OCIE1A);
+}
+
+uint16_t FrameTimer::timerNow(void)
+{
+	return TCNT1;
+}
+
+// Compare B löst nur bei TCNT1 == pos aus. Liegt pos schon hinter TCNT1
+// (auch pos 0 aus tick() nach dem CTC-Überlauf), käme er erst eine Periode
+// später: dann gleich ausschalten. Ein Treffer nach dem Löschen von OCF1B
+// setzt das Flag wieder und läuft über die ISR
+void FrameTimer::ledOffAt(uint16_t pos)
+{
+	OCR1B = pos;
+	TIFR1 = _BV(OCF1B);
+	TIMSK1 |= _BV(OCIE1B);
+	if (TCNT1 >= pos && !(TIFR1 & _BV(OCF1B))) ledOff();
+}
+
+static inline void compBStop(void)
+{
+	TIMSK1 &= ~_BV(OCIE1B);
+}
+
+void FrameTimer::ledOff(void)
+{
+	compBStop();
+	if (_ledPort) *_ledPort &= ~_ledMask;
+}
+
+static inline void ledOn(volatile uint8_t *port, uint8_t mask)
+{
+	*port |= mask;
+}
+
+#else
+
+static uint64_t hostStart;			// Takt von TCNT1 = 0 in Periode 0
+static uint64_t hostPeriod;			// Takte je Periode
+static uint32_t hostDone;			// abgearbeitete COMPA-Ticks
+static uint64_t hostLedOff;			// Takt für COMPB, 0 = gesperrt
+
+static void timerStart(uint16_t top)
+{
+	hostStart = hostCycles;
+	hostPeriod = (uint64_t)(top + 1) * FT_PRESCALE;
+	hostDone = 0;
+	hostLedOff = 0;
+}
+
+uint16_t FrameTimer::timerNow(void)
+{
+	poll();
+	return (uint16_t)((hostCycles - hostStart - hostDone * hostPeriod) / FT_PRESCALE);
+}
+
+void FrameTimer::ledOffAt(uint16_t pos)
+{
+	uint64_t periodStart = hostStart + hostDone * hostPeriod;
+	hostLedOff = periodStart + (uint64_t)pos * FT_PRESCALE;
+	if (hostLedOff <= hostCycles) ledOff();	// Position schon vorbei: sofort aus wie auf dem AVR
+}
+
+static inline void compBStop(void)
+{
+	hostLedOff = 0;
+}
+
+void FrameTimer::ledOff(void)
+{
+	compBStop();
+	if (_ledPort) hostPortWrite(_ledPort, *_ledPort & ~_ledMask);
+}
+
+static inline void ledOn(volatile uint8_t *port, uint8_t mask)
+{
+	hostPortWrite(port, *port | mask);
+}
+
+// ISR-Aufrufe zum richtigen Takt nachholen, danach zurück auf "jetzt"
+void FrameTimer::poll(void)
+{
+	if (!hostPeriod) return;
+	uint64_t now = hostCycles;
+	for (;;) {
+		uint64_t nextA = hostStart + (uint64_t)(hostDone + 1) * hostPeriod;
+		bool isB = hostLedOff && hostLedOff < nextA;
+		uint64_t t = isB ? hostLedOff : nextA;
+		if (t > now) break;
+		hostCycles = t;
+		if (isB) {
+			ledOff();
+		} else {
+			hostDone++;
+			tick();
+		}
+	}
+	hostCycles = now;
+}
+
+#endif
+
+// ======================== Bildtakt ========================
+void FrameTimer::begin(uint16_t periodMs)
+{
+	uint32_t top = (uint32_t)periodMs * FT_TICKS_PER_MS;
+	if (top > 65536UL) top = 65536UL;
+	if (top < 2) top = 2;
+	_top = top - 1;
+	_pending = 0;
+	_frames = 0;
+	_ledLeft = 0;
+	resetStats();
+	timerStart(_top);
+	sei();
+}
+
+void FrameTimer::tick(void)
+{
+	if (_pending < 255) _pending++;
+	_frames++;
+	if (_ledLeft && !--_ledLeft) ledOffAt(_ledPos);
+}
+
+void FrameTimer::waitForNextFrame(void)
+{
+#ifdef MYARDUINO_HOST
+	poll();
+#endif
+	uint8_t sreg = SREG;
+	cli();
+	uint8_t pending = _pending;
+	uint16_t now = timerNow();
+#if defined(__AVR__)
+	if (TIFR1 & _BV(OCF1A)) now = _top;	// Tick gerade eben, ISR steht noch aus
+#endif
+	SREG = sreg;
+
+	if (pending) {					// Tick schon vorbei: Frame war zu lang,
+		uint16_t o = _overruns + pending;	// jede verpasste Periode zählt
+		_overruns = (o < _overruns) ? 0xFFFF : o;
+		_lastIdle = 0;
+	} else {
+		_lastIdle = _top - now;
+		_idleSum += _lastIdle;
+		while (!_pending) {
+#ifdef MYARDUINO_HOST
+			hostCycles = hostStart + (uint64_t)(hostDone + 1) * hostPeriod;
+			poll();
+#endif
+		}
+	}
+	sreg = SREG;
+	cli();
+	_pending = 0;
+	SREG = sreg;
+}
+
+uint16_t FrameTimer::lastIdleUs(void)
+{
+	return (uint32_t)_lastIdle * 1000UL / FT_TICKS_PER_MS;
+}
+
+uint8_t FrameTimer::idlePercent(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	uint32_t n = _frames - _statStart;
+	SREG = sreg;
+	uint64_t part = (uint64_t)n * (_top + 1UL) / 100;	// Timer-Takte je Prozent
+	if (!part) return 0;
+	uint64_t p = _idleSum / part;
+	return (p > 100) ? 100 : p;
+}
+
+void FrameTimer::resetStats(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	_statStart = _frames;
+	SREG = sreg;
+	_idleSum = 0;
+	_lastIdle = 0;
+	_overruns = 0;
+}
+
+// ======================== Status-LED ========================
+void FrameTimer::statusLed(volatile uint8_t *port, uint8_t bit)
+{
+	_ledPort = port;
+	_ledMask = _BV(bit);
+}
+
+void FrameTimer::blink(uint16_t ms)
+{
+	if (!_ledPort) return;
+	uint8_t sreg = SREG;
+	cli();
+	ledOn(_ledPort, _ledMask);
+	compBStop();
+	uint32_t t = timerNow() + (uint32_t)ms * FT_TICKS_PER_MS;	// ab Beginn der laufenden Periode
+	uint32_t left = t / (_top + 1UL);
+	_ledPos = t % (_top + 1UL);
+	_ledLeft = (left > 255) ? 255 : left;
+	if (!_ledLeft) ledOffAt(_ledPos);
+	SREG = sreg;
+}
@@ -0,0 +1,63 @@
+/*
+ * FrameTimer.h
+ * Fester Bildtakt über Timer1 (CTC, Vorteiler 64) statt _delay_ms():
+ * waitForNextFrame() wartet bis zum nächsten Tick, die Rechen- und
+ * Sendezeit des Frames zählt also mit. Zählt verpasste Ticks (Frame
+ * dauerte länger als die Periode, jede übersprungene Periode zählt)
+ * und die Wartezeit (Reserve).
+ * Die Status-LED schaltet eine ISR aus, blink() blockiert nicht.
+ *
+ * Periode max. 262 ms bei 16 MHz. Sperrt die Ausgabe die Interrupts
+ * (CLI_HIGH) länger als eine Periode, geht ein Tick verloren.
+ * Belegt Timer1 mit TIMER1_COMPA_vect (Bildtakt) und TIMER1_COMPB_vect
+ * (Status-LED aus).
+ *
+ * Created: 16.10.2026 21:05:12
+ *  Author: Iggy
+ */
+#ifndef FrameTimer_h
+#define FrameTimer_h
+
+#include "myarduino.h"
+
+class FrameTimer
+{
+public:
+	static void begin(uint16_t periodMs);		// Timer1 starten, Interrupts ein
+	static void waitForNextFrame(void);			// bis zum nächsten Tick warten
+
+	static uint32_t frames(void) { return _frames; }		// Ticks seit begin()
+	static uint16_t overruns(void) { return _overruns; }	// verpasste Ticks (Frames zu lang)
+	static uint16_t lastIdleUs(void);			// Wartezeit vor dem letzten Tick
+	static uint8_t idlePercent(void);			// Anteil Wartezeit seit resetStats()
+	static void resetStats(void);
+
+	// Status-LED: Pin muss als Ausgang gesetzt sein. blink() schaltet die LED
+	// sofort an, der Compare B von Timer1 nach ms wieder aus
+	static void statusLed(volatile uint8_t *port, uint8_t bit);
+	static void blink(uint16_t ms);
+
+	static void tick(void);						// Rumpf der ISR TIMER1_COMPA_vect
+	static void ledOff(void);					// Rumpf der ISR TIMER1_COMPB_vect
+
+private:
+	static uint16_t timerNow(void);				// TCNT1
+	static void ledOffAt(uint16_t pos);			// COMPB bei TCNT1 == pos, schon vorbei: sofort aus
+#ifdef MYARDUINO_HOST
+	static void poll(void);						// fällige Compare-Ereignisse nachholen
+#endif
+
+	static volatile uint8_t _pending;			// Ticks seit dem letzten waitForNextFrame()
+	static volatile uint32_t _frames;
+	static volatile uint8_t _ledLeft;			// COMPA-Ticks bis COMPB freigegeben wird
+	static uint16_t _ledPos;					// TCNT1 für LED aus
+	static uint16_t _overruns;
+	static uint16_t _top;						// OCR1A
+	static uint16_t _lastIdle;					// in Timer-Takten (4 µs bei 16 MHz)
+	static uint64_t _idleSum;					// Timer-Takte, 32 Bit reichen nur ~4,8 h
+	static uint32_t _statStart;					// _frames bei resetStats()
+	static volatile uint8_t *_ledPort;
+	static uint8_t _ledMask;
+};
+
+#endif
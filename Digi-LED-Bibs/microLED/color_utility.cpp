@@ -1,9 +1,31 @@
 #include "color_utility.h"
-#include <math.h>
 
 // ============================================== COLOR FUNC ===============================================
+#ifdef MYARDUINO_HOST
+// хост: такты на диод (оценка по инструкциям avr-gcc -Os, можно задать через -D)
+// MLED_HOST_CK_GETFADE - getFade: вызов, проверка на 0, 3 x fade8 (MUL), распаковка/упаковка для 1 и 2
+// MLED_HOST_CK_NSCALE  - nscale8: LD, 3 x scale8 (MUL), ST, цикл; для 1 и 2 с распаковкой/упаковкой
+// MLED_HOST_CK_GETBLEND - getBlend: цикл x >= amount, 3 x (SUB, MUL 16x16, __divmodhi4 ~230), упаковка
+// MLED_HOST_CK_BLEND_BEGIN - mBlend::begin: 3 x __udivmodhi4 (частное и остаток за раз), знаки, поля
+#ifndef MLED_HOST_CK_GETFADE
+#define MLED_HOST_CK_GETFADE ((COLOR_DEBTH == 1) ? 48 : (COLOR_DEBTH == 2) ? 58 : 34)
+#endif
+#ifndef MLED_HOST_CK_NSCALE
+#define MLED_HOST_CK_NSCALE ((COLOR_DEBTH == 1) ? 34 : (COLOR_DEBTH == 2) ? 44 : 28)
+#endif
+#ifndef MLED_HOST_CK_GETBLEND
+#define MLED_HOST_CK_GETBLEND 760
+#endif
+#ifndef MLED_HOST_CK_BLEND_BEGIN
+#define MLED_HOST_CK_BLEND_BEGIN 700
+#endif
+#endif
+
 mData getFade(mData data, uint8_t val)
 {
+#ifdef MYARDUINO_HOST
+    hostTick(MLED_HOST_CK_GETFADE);
+#endif
     if (data == 0) return 0;
     val = 255 - val;
     return mergeRGBraw(fade8R(data, val), fade8G(data, val), fade8B(data, val));
@@ -13,8 +35,93 @@ uint32_t getHEX(mData data) {
     return RGBto24(getR(data), getG(data), getB(data));
 }
 
+// x * (s + 1) >> 8 на умножении 8x8
+#define scale8(x, s) (((uint16_t)(x) * (s) + (x)) >> 8)
+
+void nscale8(mData *buf, int len, uint8_t scale)
+{
+    if (scale == 255) return;
+#if (COLOR_DEBTH == 3)
+    // буфер как массив байт, по диоду за проход
+    uint8_t *p = (uint8_t *)buf;
+    while (len--) {
+#ifdef MYARDUINO_HOST
+        hostTick(MLED_HOST_CK_NSCALE);
+#endif
+        p[0] = scale8(p[0], scale);
+        p[1] = scale8(p[1], scale);
+        p[2] = scale8(p[2], scale);
+        p += 3;
+    }
+#else
+    while (len--) {
+#ifdef MYARDUINO_HOST
+        hostTick(MLED_HOST_CK_NSCALE);
+#endif
+        mData c = *buf;
+        *buf++ = mergeRGBraw(scale8(getR(c), scale), scale8(getG(c), scale), scale8(getB(c), scale));
+    }
+#endif
+}
+
+void transpose8(const uint8_t *in, uint8_t *out)
+{
+#ifdef __AVR__
+    // по выходному байту за проход: старший бит каждой линии через перенос в out[k],
+    // линия 7 первой - после 8 ROL она в бите 7. 21 такт на байт, всё в регистрах
+    uint8_t a0 = in[0], a1 = in[1], a2 = in[2], a3 = in[3];
+    uint8_t a4 = in[4], a5 = in[5], a6 = in[6], a7 = in[7];
+    uint8_t r, cnt;
+    asm volatile
+    (
+    "LDI %[CNT], 8         \n\t"
+    "_BIT_%=:              \n\t"
+    "LSL %[A7]             \n\t"  // 1CK старший бит линии 7 в перенос
+    "ROL %[R]              \n\t"  // 1CK и в результат
+    "LSL %[A6]             \n\t"
+    "ROL %[R]              \n\t"
+    "LSL %[A5]             \n\t"
+    "ROL %[R]              \n\t"
+    "LSL %[A4]             \n\t"
+    "ROL %[R]              \n\t"
+    "LSL %[A3]             \n\t"
+    "ROL %[R]              \n\t"
+    "LSL %[A2]             \n\t"
+    "ROL %[R]              \n\t"
+    "LSL %[A1]             \n\t"
+    "ROL %[R]              \n\t"
+    "LSL %[A0]             \n\t"
+    "ROL %[R]              \n\t"
+    "ST Z+, %[R]           \n\t"  // 2CK
+    "DEC %[CNT]            \n\t"  // 1CK
+    "BRNE _BIT_%=          \n\t"  // 2CK
+    :[R] "=&r" (r), [CNT] "=&d" (cnt),
+    [A0] "+r" (a0), [A1] "+r" (a1), [A2] "+r" (a2), [A3] "+r" (a3),
+    [A4] "+r" (a4), [A5] "+r" (a5), [A6] "+r" (a6), [A7] "+r" (a7),
+    "+z" (out)
+    :
+    :"memory"
+    );
+#else
+    // 64 бита: три обмена блоков 1x1, 2x2, 4x4 бит относительно диагонали
+    uint64_t x = 0;
+    for (uint8_t i = 0; i < 8; i++) x |= (uint64_t)in[i] << (8 * i);
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x ^= t ^ (t << 28);
+    for (uint8_t i = 0; i < 8; i++) out[i] = x >> (8 * (7 - i));
+#endif
+}
+
 mData getBlend(int x, int amount, mData c0, mData c1)
 {
+#ifdef MYARDUINO_HOST
+    hostTick(MLED_HOST_CK_GETBLEND);
+#endif
     while (x >= amount) x -= amount;
     amount -= 1;
     return mergeRGBraw(
@@ -24,6 +131,29 @@ mData getBlend(int x, int amount, mData c0, mData c1)
     );
 }
 
+void mBlend::begin(int amount, mData c0, mData c1)
+{
+#ifdef MYARDUINO_HOST
+    hostTick(MLED_HOST_CK_BLEND_BEGIN);
+#endif
+    uint8_t a[3] = {(uint8_t)getR(c0), (uint8_t)getG(c0), (uint8_t)getB(c0)};
+    uint8_t b[3] = {(uint8_t)getR(c1), (uint8_t)getG(c1), (uint8_t)getB(c1)};
+    _n = (amount > 1) ? amount - 1 : 1;
+    _neg = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+        int d = (amount > 1) ? b[i] - a[i] : 0;
+        if (d < 0) {
+            d = -d;
+            _neg |= 1 << i;             // getBlend делит с округлением к нулю - шагаем по модулю
+        }
+        _base[i] = a[i];
+        _dq[i] = d / _n;
+        _dr[i] = d % _n;
+        _quo[i] = 0;
+        _rem[i] = 0;
+    }
+}
+
 mData mRGB(uint8_t r, uint8_t g, uint8_t b) {
     return mergeRGB(r, g, b);
 }
@@ -48,33 +178,34 @@ mData mHSVfast(uint8_t h, uint8_t s, uint8_t v)
     return mRGB(r, g, b);
 }
 
+// x / 255 без деления, точно для x < 65280
+static inline uint8_t div255(uint16_t x)
+{
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
 mData mHSV(uint8_t h, uint8_t s, uint8_t v)
 {    
-    // обычный HSV
-    float r, g, b;
-    
-    float H = h / 255.0;
-    float S = s / 255.0;
-    float V = v / 255.0;
-    
-    int i = int(H * 6);
-    float f = H * 6 - i;
-    float p = V * (1 - S);
-    float q = V * (1 - f * S);
-    float t = V * (1 - (1 - f) * S);
+    // обычный HSV, целочисленный (отличие от расчёта во float не больше 1)
+    uint16_t hh = h * 6;
+    uint8_t i = div255(hh);                     // сектор 0-6
+    uint8_t f = hh - i * 255;                   // положение в секторе 0-254
+    uint8_t fs = div255(f * s + 127);           // f * S, округлённое
+    uint8_t p = div255(v * (255 - s));
+    uint8_t q = div255(v * (255 - fs));
+    uint8_t t = div255(v * (255 - s + fs));
+    uint8_t r, g, b;
     
-    switch (i % 6) {
-    case 0: r = V, g = t, b = p; break;
-    case 1: r = q, g = V, b = p; break;
-    case 2: r = p, g = V, b = t; break;
-    case 3: r = p, g = q, b = V; break;
-    case 4: r = t, g = p, b = V; break;
-    case 5: r = V, g = p, b = q; break;    
+    switch (i) {
+    case 0: 
+    case 6: r = v, g = t, b = p; break;
+    case 1: r = q, g = v, b = p; break;
+    case 2: r = p, g = v, b = t; break;
+    case 3: r = p, g = q, b = v; break;
+    case 4: r = t, g = p, b = v; break;
+    default: r = v, g = p, b = q; break;    
     }
-    r *= 255.0;
-    g *= 255.0;
-    b *= 255.0;
-    return mRGB((byte)r, (byte)g, (byte)b);
+    return mRGB(r, g, b);
 }
 
 mData mHEX(uint32_t color) {
@@ -83,7 +214,7 @@ mData mHEX(uint32_t color) {
 
 mData mWheel(int color, uint8_t bright) 
 {
-    uint8_t r, g, b;
+    uint8_t r = 0, g = 0, b = 0;                // вне 0..1530 - чёрный
     if (color <= 255) {                         // красный макс, зелёный растёт
         r = 255;
         g = color;
@@ -150,46 +281,75 @@ mData mWheel8(uint8_t color, uint8_t bright)
     return mRGB(r, g, b);
 }
 
+// mKelvin по таблице с шагом 100 K, значения посчитаны по прежним формулам во float
+// (генератор: tools/kelvin_table.cpp), T = kelvin / 100:
+// R = 329.698727446 * (T - 60)^-0.1332047592 при T > 66, иначе 255
+// G = 99.4708025861 * ln(T) - 161.1195681661 при T <= 66, иначе 288.1221695283 * (T - 60)^-0.0755148492
+// B = 138.5177312231 * ln(T - 10) - 305.0447927307 при 19 < T < 66, 0 при T <= 19, 255 при T >= 66
+// всё с ограничением 0-255 и отбрасыванием дробной части. В таблицах только непостоянные участки.
+// Между узлами линейная интерполяция по kelvin % 100, в узлах (кратно 100 K) - как прежняя формула
+static const uint8_t _kelvinR[234] PROGMEM = {
+    254, 249, 246, 242, 239, 236, 234, 231, 229, 227, 226, 224, 222, 221, 219, 218,
+    217, 215, 214, 213, 212, 211, 210, 209, 208, 207, 206, 206, 205, 204, 203, 203,
+    202, 201, 201, 200, 199, 199, 198, 197, 197, 196, 196, 195, 195, 194, 194, 193,
+    193, 192, 192, 191, 191, 191, 190, 190, 189, 189, 189, 188, 188, 187, 187, 187,
+    186, 186, 186, 185, 185, 185, 184, 184, 184, 183, 183, 183, 183, 182, 182, 182,
+    181, 181, 181, 181, 180, 180, 180, 180, 179, 179, 179, 179, 178, 178, 178, 178,
+    177, 177, 177, 177, 176, 176, 176, 176, 176, 175, 175, 175, 175, 175, 174, 174,
+    174, 174, 174, 173, 173, 173, 173, 173, 172, 172, 172, 172, 172, 172, 171, 171,
+    171, 171, 171, 171, 170, 170, 170, 170, 170, 170, 169, 169, 169, 169, 169, 169,
+    168, 168, 168, 168, 168, 168, 168, 167, 167, 167, 167, 167, 167, 167, 167, 166,
+    166, 166, 166, 166, 166, 166, 165, 165, 165, 165, 165, 165, 165, 165, 164, 164,
+    164, 164, 164, 164, 164, 164, 164, 163, 163, 163, 163, 163, 163, 163, 163, 163,
+    162, 162, 162, 162, 162, 162, 162, 162, 162, 161, 161, 161, 161, 161, 161, 161,
+    161, 161, 161, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 159, 159, 159,
+    159, 159, 159, 159, 159, 159, 159, 159, 158, 158,
+};
+static const uint8_t _kelvinG[291] PROGMEM = {
+    67, 77, 86, 94, 101, 108, 114, 120, 126, 131, 136, 141, 146, 150, 155, 159,
+    162, 166, 170, 173, 177, 180, 183, 186, 189, 192, 195, 198, 200, 203, 205, 208,
+    210, 213, 215, 217, 219, 221, 223, 226, 228, 229, 231, 233, 235, 237, 239, 241,
+    242, 244, 246, 247, 249, 251, 252, 254, 255, 248, 246, 244, 242, 240, 238, 237,
+    236, 234, 233, 232, 231, 230, 229, 228, 228, 227, 226, 225, 225, 224, 224, 223,
+    222, 222, 221, 221, 220, 220, 219, 219, 218, 218, 218, 217, 217, 216, 216, 216,
+    215, 215, 215, 214, 214, 214, 213, 213, 213, 212, 212, 212, 212, 211, 211, 211,
+    210, 210, 210, 210, 209, 209, 209, 209, 209, 208, 208, 208, 208, 207, 207, 207,
+    207, 207, 206, 206, 206, 206, 206, 206, 205, 205, 205, 205, 205, 204, 204, 204,
+    204, 204, 204, 203, 203, 203, 203, 203, 203, 203, 202, 202, 202, 202, 202, 202,
+    202, 201, 201, 201, 201, 201, 201, 201, 200, 200, 200, 200, 200, 200, 200, 200,
+    199, 199, 199, 199, 199, 199, 199, 199, 199, 198, 198, 198, 198, 198, 198, 198,
+    198, 198, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 196, 196, 196, 196,
+    196, 196, 196, 196, 196, 196, 196, 195, 195, 195, 195, 195, 195, 195, 195, 195,
+    195, 195, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 193,
+    193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 192, 192, 192, 192,
+    192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 191, 191, 191, 191, 191, 191,
+    191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 190, 190, 190, 190, 190, 190,
+    190, 190, 190,
+};
+static const uint8_t _kelvinB[46] PROGMEM = {
+    13, 27, 39, 50, 60, 70, 79, 87, 95, 102, 109, 116, 123, 129, 135, 140,
+    146, 151, 156, 161, 166, 170, 175, 179, 183, 187, 191, 195, 198, 202, 205, 209,
+    212, 215, 219, 222, 225, 228, 231, 234, 236, 239, 242, 244, 247, 250,
+};
+
+static uint8_t _kelvinRAt(uint16_t t) { return (t <= 66) ? 255 : pgm_read_byte(&_kelvinR[t - 67]); }
+static uint8_t _kelvinGAt(uint16_t t) { return pgm_read_byte(&_kelvinG[t - 10]); }
+static uint8_t _kelvinBAt(uint16_t t) { return (t >= 66) ? 255 : ((t <= 19) ? 0 : pgm_read_byte(&_kelvinB[t - 20])); }
+
+// a + (b - a) * w / 256
+static inline uint8_t _kelvinLerp(uint8_t a, uint8_t b, uint8_t w)
+{
+    return a + (((int16_t)b - a) * w >> 8);
+}
+
 mData mKelvin(int kelvin)
 {
-    float tmpKelvin, tmpCalc;
-    uint8_t _r, _g, _b;
-    
-    kelvin = constrain(kelvin, 1000, 30000);
-    tmpKelvin = kelvin / 100;
-    
-    // red
-    if (tmpKelvin <= 66) _r = 255;
-    else {
-        tmpCalc = tmpKelvin - 60;
-        tmpCalc = (float)pow(tmpCalc, -0.1332047592);
-        tmpCalc *= (float)329.698727446;
-        tmpCalc = constrain(tmpCalc, 0, 255);
-        _r = tmpCalc;
-    }
-    
-    // green
-    if (tmpKelvin <= 66) {
-        tmpCalc = tmpKelvin;
-        tmpCalc = (float)99.4708025861 * log(tmpCalc) - 161.1195681661;
-        tmpCalc = constrain(tmpCalc, 0, 255);
-        _g = tmpCalc;
-    } else {
-        tmpCalc = tmpKelvin - 60;
-        tmpCalc = (float)pow(tmpCalc, -0.0755148492);
-        tmpCalc *= (float)288.1221695283;
-        tmpCalc = constrain(tmpCalc, 0, 255);
-        _g = tmpCalc;
-    }
-    
-    // blue
-    if (tmpKelvin >= 66) _b = 255;
-    else if (tmpKelvin <= 19) _b = 0;
-    else {
-        tmpCalc = tmpKelvin - 10;
-        tmpCalc = (float)138.5177312231 * log(tmpCalc) - 305.0447927307;
-        tmpCalc = constrain(tmpCalc, 0, 255);
-        _b = tmpCalc;
-    }
+    uint16_t k = constrain(kelvin, 1000, 30000);
+    uint16_t t = k / 100;
+    uint8_t w = (uint8_t)(k % 100) * 41 >> 4;     // 0..99 -> 0..253, ~ * 256 / 100
+    uint16_t t2 = (t < 300) ? t + 1 : t;
+    uint8_t _r = _kelvinLerp(_kelvinRAt(t), _kelvinRAt(t2), w);
+    uint8_t _g = _kelvinLerp(_kelvinGAt(t), _kelvinGAt(t2), w);
+    uint8_t _b = _kelvinLerp(_kelvinBAt(t), _kelvinBAt(t2), w);
     return mRGB(_r, _g, _b);
 }
\ No newline at end of file
@@ -102,8 +102,13 @@ enum COLORS
 
 uint32_t getHEX(mData data);                            // перепаковать в 24 бит HEX
 mData getFade(mData data, uint8_t val);                 // уменьшить яркость на val
+void nscale8(mData *buf, int len, uint8_t scale);       // умножить len цветов на (scale+1)/256 (= getFade на 255-scale)
 mData getBlend(int x, int amount, mData c0, mData c1);  // получить промежуточный цвет
 
+// транспонирование 8x8 бит для параллельного вывода: бит (7-k) байта in[l] -> бит l байта out[k],
+// т.е. out[k] - k-й бит (от старшего) всех восьми линий. AVR: asm LSL/ROL, 168 тактов + загрузка 16
+void transpose8(const uint8_t *in, uint8_t *out);
+
 mData mRGB(uint8_t r, uint8_t g, uint8_t b);            // RGB 255, 255, 255
 mData mWheel(int color, uint8_t bright=255);            // цвета 0-1530 + яркость 
 mData mWheel8(uint8_t color, uint8_t bright=255);       // цвета 0-255 + яркость
@@ -190,9 +195,13 @@ static const uint8_t _CRTgammaPGM[256] PROGMEM = {
 #define mergeRGB(r,g,b)    (((getCRT(r) & 0b11000000) | ((getCRT(g) & 0b11100000) >> 2) | (getCRT(b) & 0b11100000) >> 5))
 #define mergeRGBraw(r,g,b)    ((((r) & 0b11000000) | (((g) & 0b11100000) >> 2) | ((b) & 0b11100000) >> 5))
 #elif (COLOR_DEBTH == 2)
-#define getR(x)            (((x) & 0b1111100000000000) >> 8)
-#define getG(x)            (((x) & 0b0000011111100000) >> 3)
-#define getB(x)            (((x) & 0b0000000000011111) << 3)
+// распаковка по байтам (без 16-битных сдвигов на AVR), в asm вывода не переносится - см. README
+static inline MICROLED_INLINE uint8_t _getG565(uint16_t x) {
+    return ((uint8_t)(x >> 8) << 5) | (((uint8_t)x >> 3) & 0b00011100);
+}
+#define getR(x)            ((uint8_t)((x) >> 8) & 0b11111000)
+#define getG(x)            _getG565(x)
+#define getB(x)            ((uint8_t)((uint8_t)(x) << 3))
 #define mergeRGB(r,g,b)    (((getCRT(r) & 0b11111000) << 8) | ((getCRT(g) & 0b11111100) << 3) | ((getCRT(b) & 0b11111000) >> 3))
 #define mergeRGBraw(r,g,b)    ((((r) & 0b11111000) << 8) | (((g) & 0b11111100) << 3) | (((b) & 0b11111000) >> 3))
 #elif (COLOR_DEBTH == 3)    
@@ -210,6 +219,40 @@ static const uint8_t _CRTgammaPGM[256] PROGMEM = {
 #define fade8B(x, b)     fade8(getB(x), (b))
 
 // ============================================ GRADIENT =============================================
+#ifdef MYARDUINO_HOST
+// хост: такты mBlend::next (оценка): 3 x (выбор знака, ADD, ADD/ADC остатка, CP, условный SUB/INC)
+#ifndef MLED_HOST_CK_BLEND_STEP
+#define MLED_HOST_CK_BLEND_STEP ((COLOR_DEBTH == 3) ? 40 : 48)
+#endif
+#endif
+
+// пошаговый градиент: next() по очереди отдаёт getBlend(0, amount, c0, c1), getBlend(1, ...) и т.д.
+// деление только в begin(), на каждый пиксель - сложения (DDA с остатком, результат как у getBlend)
+struct mBlend
+{
+    void begin(int amount, mData c0, mData c1);
+    inline mData next() MICROLED_INLINE {
+        uint8_t c[3];
+#ifdef MYARDUINO_HOST
+        hostTick(MLED_HOST_CK_BLEND_STEP);
+#endif
+        for (uint8_t i = 0; i < 3; i++) {
+            c[i] = (_neg & (1 << i)) ? _base[i] - _quo[i] : _base[i] + _quo[i];
+            _quo[i] += _dq[i];
+            _rem[i] += _dr[i];
+            if (_rem[i] >= _n) {
+                _rem[i] -= _n;
+                _quo[i]++;
+            }
+        }
+        return mergeRGBraw(c[0], c[1], c[2]);
+    }
+
+    uint8_t _base[3], _quo[3], _dq[3];
+    uint16_t _rem[3], _dr[3], _n;
+    uint8_t _neg;
+};
+
 template <int size>
 struct mGradient
 {
@@ -219,5 +262,15 @@ struct mGradient
         int sector = x / sectorSize;
         return getBlend(x-sector*sectorSize, sectorSize, colors[sector], colors[sector+1]);
     }
+
+    // залить buf целиком: то же, что get(0..amount-1, amount), но без делений на каждый пиксель
+    void fill(mData *buf, int amount) {
+        int sectorSize = (amount + size - 2) / (size - 1);
+        mBlend blend;
+        for (int sector = 0, x = 0; x < amount; sector++) {
+            blend.begin(sectorSize, colors[sector], colors[sector + 1]);
+            for (int i = 0; i < sectorSize && x < amount; i++, x++) buf[x] = blend.next();
+        }
+    }
 };
 #endif
\ No newline at end of file
@@ -37,9 +37,12 @@
 #define COLOR_DEBTH 3    // по умолчанию 24 бита
 #endif
 
+#ifdef __AVR__
 #include <util/atomic.h>
+#endif
 
 //#include "Arduino.h"
+#include <string.h>
 #include "color_utility.h"
 #include "types.h"
 
@@ -51,6 +54,141 @@
 #define MLED_SPI_CLOCK 8000000
 #endif
 
+// MLED_STAGE_CHUNK - вывод через промежуточный буфер (только WS281x/WS6812):
+// show() готовит кусок из MLED_STAGE_CHUNK светодиодов уже в порядке ленты и с яркостью,
+// затем отправляет его одним asm циклом. Буфер на стеке: MLED_STAGE_CHUNK * 3 (4) байт.
+// Подготовка куска идёт при LOW на линии - она должна укладываться в время ресета ленты!
+// Для вывода за один раз указать количество светодиодов
+//#define MLED_STAGE_CHUNK 8
+
+// MLED_PARTIAL_SHOW - show() отправляет только начало ленты до последнего изменённого диода:
+// лента защёлкивает столько диодов, сколько получила, остальные держат старый цвет.
+// Учитываются set, fill, fillGradient, fade, clear и матричные функции. После прямой записи
+// в leds[] или white[] нужно вызвать markDirty(номер). Смена яркости отправляет всю ленту
+//#define MLED_PARTIAL_SHOW
+
+// MLED_CURRENT_TRACK - сумма каналов для setMaxCurrent ведётся при записи (set, fill, fade...),
+// show() не пересчитывает ленту целиком. После прямой записи в leds[] вызвать recalcCurrent()
+//#define MLED_CURRENT_TRACK
+
+// MLED_DOUBLE_BUFFER - два буфера: рисование идёт в leds (задний), show() выводит front,
+// swap() меняет указатели (кадр не копируется). Прошлый кадр после swap() лежит в front.
+// leds и front здесь указатели, не массивы: sizeof(strip.leds) - размер указателя,
+// размер буфера - amount * sizeof(mData). Адрес leds меняется после swap(), не запоминать его.
+// SRAM: 2 * amount * COLOR_DEBTH байт, при нехватке памяти ошибка компиляции с размером. white[] один
+//#define MLED_DOUBLE_BUFFER
+
+// MLED_USART_SPI - вывод WS281x/WS6812 через USART0 в режиме SPI-мастера по прерыванию UDRE:
+// show() только запускает передачу и сразу возвращается, кадр уходит в фоне.
+// Лента подключается к TXD (PD1), пин из шаблона не используется, XCK (PD4) занят.
+// Бит ленты - 4 бита SPI при 2.67 МГц: 0 = 1000 (375/1125 нс), 1 = 1100 (750/750 нс).
+// Каждый байт SPI заканчивается нулём, поэтому опоздание прерывания только удлиняет LOW.
+// Байты SPI готовит основной цикл в кольцо на MLED_USART_RING байт (яркость, порядок, кодирование),
+// прерывание только берёт байт из кольца и пишет в UDR0. Пока кадр уходит, основной цикл должен
+// вызывать usartBusy() (дозаполняет кольцо) чаще, чем кольцо опустеет: MLED_USART_RING * 3 мкс.
+// Иначе пауза LOW в ленте, длиннее ресета - лента защёлкнет кадр раньше времени.
+// Пауза ресета (MLED_USART_RESET) уходит нулями в конце кадра, следующий show() ждёт только её остаток.
+// Прерывание ~61 такт на байт SPI, байт уходит за 96 тактов при 32 МГц: модель хоста (tests/test_usart)
+// ~63% процессора, без пауз. Только F_CPU 32 МГц (LGT8): при 16 МГц байт уходит за 48 тактов, меньше
+// прерывания, кольцо не успевает заполняться. В одном .cpp нужно объявить обработчик: MLED_USART_ISR(strip)
+// Рисовать во время передачи безопасно только в задний буфер (MLED_DOUBLE_BUFFER)
+//#define MLED_USART_SPI
+
+#ifdef MLED_USART_SPI
+#if (F_CPU != 32000000UL)
+#error "MLED_USART_SPI: F_CPU 32 MHz only (at 16 MHz the UDRE interrupt is longer than one SPI byte)"
+#endif
+#define MLED_USART_UBRR (F_CPU / 5333333UL - 1)    // 2.67 МГц: 375 нс на бит SPI
+#ifndef MLED_USART_RESET
+#define MLED_USART_RESET 300        // пауза между кадрами, мкс
+#endif
+#ifndef MLED_USART_RING
+#define MLED_USART_RING 64          // кольцо байт SPI, степень двойки до 128. 12 байт на диод (16 с W)
+#endif
+#define MLED_USART_LATCH ((MLED_USART_RESET + 2) / 3)     // нулевых байт SPI на паузу ресета (3 мкс на байт)
+#if (MLED_USART_RING & (MLED_USART_RING - 1)) || MLED_USART_RING < 16 || MLED_USART_RING > 128
+#error "MLED_USART_RING: power of two 16..128"
+#endif
+#if defined(__AVR__)
+#include <avr/interrupt.h>                   // ISR() для MLED_USART_ISR
+#endif
+#define MLED_USART_ISR(strip) ISR(USART_UDRE_vect) { strip.usartISR(); }
+#endif
+
+#ifdef MLED_DOUBLE_BUFFER
+// проверка SRAM: при ошибке компилятор показывает размер двух буферов в байтах
+// в аргументе шаблона ("required from ... mledSramCheck<байт, false>")
+template <unsigned long bytes, bool fits>
+struct mledSramCheck {
+    static_assert(fits, "microLED: MLED_DOUBLE_BUFFER does not fit in SRAM (bytes: see mledSramCheck<bytes>), use COLOR_DEBTH 2 or 1");
+    static const bool ok = fits;
+};
+#endif
+
+#ifdef MYARDUINO_HOST
+// хост: такты C-кода между asm посылками (оценка по инструкциям avr-gcc -Os, можно задать через -D)
+// MLED_HOST_CK_BYTE   - вызов sendRaw: CALL/RET, проверки isr, загрузка порта и масок
+// MLED_HOST_CK_SEND   - send(): вызов, push/pop, 3 x fade8 (MUL), порядок цветов
+// MLED_HOST_CK_PIXEL  - sendPixels на диод: счётчик, адрес, LD цвета (без get() пользователя)
+// MLED_HOST_CK_CHANNEL - sendPixels на байт: fade8 (MUL) одного канала следующего диода
+// MLED_HOST_CK_STAGE  - showStaged: один диод в буфер (LD, 3 x fade8, ST)
+// MLED_HOST_CK_CHUNK  - showStaged: вызов sendRawBuf на кусок
+// MLED_HOST_CK_UNPACK - распаковка getR/G/B для COLOR_DEBTH 1 и 2 на диод
+// MLED_HOST_CK_FADE   - fade(num): вызов, адрес диода, LD/ST (getFade считает color_utility.cpp)
+// MLED_HOST_CK_SET    - set(x, y): x * y (MUL), границы по LDS, switch по конфигурации, MUL ряда, зигзаг, 3 x ST
+// MLED_HOST_CK_SET_T  - то же с матрицей в шаблоне: границы и конфигурация константами, остаются MUL и зигзаг
+#ifndef MLED_HOST_CK_BYTE
+#define MLED_HOST_CK_BYTE 26
+#endif
+#ifndef MLED_HOST_CK_SEND
+#define MLED_HOST_CK_SEND 70
+#endif
+#ifndef MLED_HOST_CK_PIXEL
+#define MLED_HOST_CK_PIXEL 14
+#endif
+#ifndef MLED_HOST_CK_CHANNEL
+#define MLED_HOST_CK_CHANNEL 8
+#endif
+#ifndef MLED_HOST_CK_STAGE
+#define MLED_HOST_CK_STAGE 41
+#endif
+#ifndef MLED_HOST_CK_CHUNK
+#define MLED_HOST_CK_CHUNK 30
+#endif
+#ifndef MLED_HOST_CK_UNPACK
+#define MLED_HOST_CK_UNPACK ((COLOR_DEBTH == 1) ? 8 : (COLOR_DEBTH == 2) ? 17 : 0)
+#endif
+#ifndef MLED_HOST_CK_FADE
+#define MLED_HOST_CK_FADE 22
+#endif
+#ifndef MLED_HOST_CK_SET
+#define MLED_HOST_CK_SET 62
+#endif
+#ifndef MLED_HOST_CK_SET_T
+#define MLED_HOST_CK_SET_T 40
+#endif
+#ifdef MLED_USART_SPI
+// MLED_HOST_CK_USART_ISR   - прерывание UDRE целиком (см. usartISR), _UDR - до записи UDR0
+// MLED_HOST_CK_USART_PIXEL - usartFill на диод: 3 x fade8, порядок, 12 x (таблица, ST, индекс)
+// MLED_HOST_CK_USART_ZERO  - usartFill на нулевой байт паузы, MLED_HOST_CK_POLL - вызов usartBusy()
+#ifndef MLED_HOST_CK_USART_ISR
+#define MLED_HOST_CK_USART_ISR 61
+#endif
+#ifndef MLED_HOST_CK_USART_UDR
+#define MLED_HOST_CK_USART_UDR 35
+#endif
+#ifndef MLED_HOST_CK_USART_PIXEL
+#define MLED_HOST_CK_USART_PIXEL ((CHIP4COLOR) ? 150 : 115)
+#endif
+#ifndef MLED_HOST_CK_USART_ZERO
+#define MLED_HOST_CK_USART_ZERO 4
+#endif
+#ifndef MLED_HOST_CK_POLL
+#define MLED_HOST_CK_POLL 12
+#endif
+#endif
+#endif
+
 #define CHIP4COLOR (chip == LED_WS6812)
 const uint8_t SAVE_MILLIS = 1;
 const int8_t MLED_NO_CLOCK = -1;
@@ -70,7 +208,12 @@ void systemUptimePoll(void);    // дёрнуть миллисы
 // void fill(mData color);                          // заливка цветом mData
 // void fill(int from, int to, mData color);        // заливка цветом mData
 // void fillGradient(int from, int to, mData color1, mData color2);    // залить градиентом двух цветов
+// void fillGradient(int from, int to, mGradient<size> &grad);         // залить многоцветным градиентом
 // void fade(int num, byte val);                    // уменьшить яркость
+// void fadeAll(byte val);                          // уменьшить яркость всех диодов
+// void fadeRange(int from, int to, byte val);      // уменьшить яркость диодов from..to
+// void swap();                                     // поменять задний и передний буфер (MLED_DOUBLE_BUFFER)
+// void markDirty(int num);                         // отметить диод изменённым (MLED_PARTIAL_SHOW)
 //
 // // матрица
 // uint16_t getPixNumber(int x, int y);             // получить номер пикселя в ленте по координатам
@@ -80,31 +223,58 @@ void systemUptimePoll(void);    // дёрнуть миллисы
 // void drawBitmap8(int X, int Y, const uint8_t *frame, int width, int height);    // вывод битмапа (битмап 1мерный PROGMEM)
 // void drawBitmap16(int X, int Y, const uint16_t *frame, int width, int height);    // вывод битмапа (битмап 1мерный PROGMEM)
 // void drawBitmap32(int X, int Y, const uint32_t *frame, int width, int height);    // вывод битмапа (битмап 1мерный PROGMEM)
+// void hline(int x, int y, int len, mData color);  // горизонтальная линия
+// void vline(int x, int y, int len, mData color);  // вертикальная линия
+// void fillRect(int x, int y, int w, int h, mData color);  // залить прямоугольник
+// void blitRow(int x, int y, const mData *data, int len);  // скопировать массив цветов в строку y с x
+// void scroll(int dx, int dy, mData color = 0);    // сдвинуть картинку, освободившееся место залить color
 //
 // // общее
 // void setMaxCurrent(int ma);                      // установить максимальный ток (автокоррекция яркости). 0 - выключено
+// void recalcCurrent();                            // пересчитать ток после записи в leds[] (MLED_CURRENT_TRACK)
 // void setBrightness(uint8_t newBright);           // яркость 0-255
 // void clear();                                    // очистка
 // void setCLI(type);                               // режим запрета прерываний CLI_OFF, CLI_LOW, CLI_AVER, CLI_HIGH
 //
 // // вывод буфера
-// void show();                                     // вывести весь буфер
+// void show();                                     // вывести весь буфер (с MLED_STAGE_CHUNK - кусками через буфер)
+// void showGenerated(f, frame, count);             // вывод без буфера, цвет от mData f(int i, int x, int y, uint16_t frame)
+//                                                  // (WS6812: f(i, x, y, frame, byte &white) задаёт и белый)
+// void showPipelined(render, chunk);               // render(from, to) рисует кусок, пока предыдущий передаётся (MLED_USART_SPI)
 //
 // // вывод потока
 // void begin();                                    // начать вывод потоком
 // void send(mData data);                           // отправить один светодиод
+// void sendPixels(get, count);                     // отправить count диодов, цвет от mData get(int i, byte &white)
 // void end();                                      // закончить вывод потоком
 //
+// // MLED_USART_SPI
+// bool usartBusy();                                // кадр ещё передаётся, дозаполняет кольцо (вызывать в цикле)
+// MLED_USART_ISR(strip);                           // объявить обработчик прерывания (один раз, вне функций)
+//
+// // хост (MYARDUINO_HOST)
+// bool hostLog(const char *file, int count);       // кадр leds[] в лог эталонов (hostLogCompare)
+// uint32_t hostChSum(bool ofFront);                // сумма каналов MLED_CURRENT_TRACK (для теста)
+//
 // <amount, pin, clock pin, chip, order, cli, mls> ()
 // <amount, pin, clock pin, chip, order, cli, mls> (width, height, type, conn, dir)
-// количество, пин, чип, порядок, прерывания, миллис
-template<int amount, int8_t pin, int8_t pinCLK, M_chip chip, M_order order, M_ISR def_isr = CLI_OFF, uint8_t uptime = 0>
+// <amount, pin, clock pin, chip, order, cli, mls, width, height, type, conn, dir> ()
+// количество, пин, чип, порядок, прерывания, миллис, [матрица]
+// Матрица в шаблоне: getPixNumber считается с константами, switch и ветки по типу
+// убирает компилятор. Конструктор тогда без аргументов
+template<int amount, int8_t pin, int8_t pinCLK, M_chip chip, M_order order, M_ISR def_isr = CLI_OFF, uint8_t uptime = 0,
+         uint8_t mW = 0, uint8_t mH = 0, M_type mType = ZIGZAG, M_connection mConn = LEFT_BOTTOM, M_dir mDir = DIR_RIGHT>
 class microLED
 {
 public:
     int oneLedMax = 46;
     int oneLedIdle = 2000;
+#ifdef MLED_DOUBLE_BUFFER
+    mData *leds = _buf[0];              // задний буфер, сюда рисуем
+    mData *front = _buf[1];             // передний буфер, его выводит show()
+#else
     mData leds[amount];
+#endif
     byte white[(CHIP4COLOR) ? amount : 0];
 
     void init() {
@@ -126,16 +296,26 @@ public:
         case LED_WS2813: oneLedMax = 30; oneLedIdle = 1266; break;
         case LED_WS2815: oneLedMax = 10; oneLedIdle = 1753; break;
         case LED_WS2818: oneLedMax = 46; oneLedIdle = 1900; break;
+        default: break;                     // WS6812, APA102: значения по умолчанию
         }
         // oneLedMax = (ток ленты с одним горящим) - (ток выключенной ленты)
         // oneLedIdle = (ток выключенной ленты) / (количество ледов)
 #ifdef MLED_USE_SPI
         SPI.begin();
+#endif
+#ifdef MLED_USART_SPI
+        if (chip != LED_APA102 && chip != LED_APA102_SPI) {
+            PORTD &= ~_BV(PORTD1);                  // вне кадра TXD - обычный пин с LOW
+            DDRD |= _BV(DDD1) | _BV(DDD4);          // TXD и XCK (XCK выход - режим мастера)
+            UBRR0 = 0;
+            UCSR0C = _BV(UMSEL01) | _BV(UMSEL00);  // SPI мастер, MSB первым
+            UBRR0 = MLED_USART_UBRR;
+        }
 #endif
     }
 
     microLED() :
-		_width(0), _height(0), _matrixConfig(0), _matrixType(0) {
+		_width(mW), _height(mH), _matrixConfig(_cfgT), _matrixType( (uint8_t)mType ), _matrixW(_mWT) {
         init();
     }
 
@@ -156,55 +336,118 @@ public:
 
     void clear() {
         for (int i = 0; i < amount; i++) leds[i] = 0;
+#ifdef MLED_CURRENT_TRACK
+        _chSum = 0;
+#endif
+        markDirty(amount - 1);
     }
 
     void fill(mData color) {
         for (int i = 0; i < amount; i++) leds[i] = color;
+#ifdef MLED_CURRENT_TRACK
+        _chSum = (uint32_t)chSum(color) * amount;
+#endif
+        markDirty(amount - 1);
     }
 
     void fill(int from, int to, mData color) {
-        for (int i = from; i <= to; i++) leds[i % amount] = color;
+        for (int i = from; i <= to; i++) put(i % amount, color);
+        markDirty((to < amount) ? to : amount - 1);
     }
 
     void fillGradient(int from, int to, mData color1, mData color2) {
-        for (int i = from; i < to; i++) leds[i % amount] = getBlend(i - from, to - from, color1, color2);
+        mBlend blend;
+        blend.begin(to - from, color1, color2);
+        int n = from % amount;
+        for (int i = from; i < to; i++) {
+            put(n, blend.next());
+            if (++n >= amount) n = 0;
+        }
+        markDirty((to <= amount) ? to - 1 : amount - 1);
+    }
+
+    // многоцветный градиент mGradient на диоды from..to-1 (в пределах ленты)
+    template <int size>
+    void fillGradient(int from, int to, mGradient<size> &grad) {
+        if (from < 0) from = 0;
+        if (to > amount) to = amount;
+        if (to <= from) return;
+        trackRange(from, to - 1, false);
+        grad.fill(&leds[from], to - from);
+        trackRange(from, to - 1, true);
+        markDirty(to - 1);
     }
 
     void set(int n, mData color) {
-        leds[n] = color;
+        put(n, color);
+        markDirty(n);
+    }
+
+    // отметить диод num изменённым (для MLED_PARTIAL_SHOW после прямой записи в leds[])
+    void markDirty(int num) {
+#ifdef MLED_PARTIAL_SHOW
+        if (num >= _dirty) _dirty = num + 1;
+#else
+        (void)num;
+#endif
     }
 
     mData get(int num) {
         return leds[num];
     }
 
+    // MLED_DOUBLE_BUFFER: нарисованный кадр сделать передним, прошлый передний - задним
+    void swap() {
+#ifdef MLED_DOUBLE_BUFFER
+#ifdef MLED_USART_SPI
+        while (usartBusy());                        // front ещё выводится
+#endif
+        swapBuffers();
+        markDirty(amount - 1);          // лента показывает прошлый front
+#endif
+    }
+
+    // уменьшить яркость всех диодов / диодов from..to на val (как fade, но сразу по буферу)
+    void fadeAll(byte val) {
+        fadeRange(0, amount - 1, val);
+    }
+
+    void fadeRange(int from, int to, byte val) {
+        if (from < 0) from = 0;
+        if (to >= amount) to = amount - 1;
+        if (to < from) return;
+        trackRange(from, to, false);
+        nscale8(&leds[from], to - from + 1, 255 - val);
+        trackRange(from, to, true);
+        markDirty(to);
+    }
+
     void fade(int num, byte val) {
-        leds[num] = getFade(leds[num], val);
+#ifdef MYARDUINO_HOST
+        hostTick(MLED_HOST_CK_FADE);
+#endif
+        put(num, getFade(leds[num], val));
+        markDirty(num);
     }
 
     // ============================================== МАТРИЦА ==============================================
     uint16_t getPixNumber(int x, int y) {
-        int thisX, thisY;
-        switch (_matrixConfig) {
-        case 0:   thisX = x;          thisY = y;          break;
-        case 4:   thisX = y;          thisY = x;          break;
-        case 1:   thisX = x;          thisY = (_height - y - 1);  break;
-        case 13:  thisX = (_height - y - 1);  thisY = x;          break;
-        case 10:  thisX = (_width - x - 1); thisY = (_height - y - 1);  break;
-        case 14:  thisX = (_height - y - 1);  thisY = (_width - x - 1); break;
-        case 11:  thisX = (_width - x - 1); thisY = y;          break;
-        case 7:   thisX = y;          thisY = (_width - x - 1); break;
-        }
+        if (mW) return pixNumber(x, y, _cfgT, (uint8_t)mType, mW, mH, _mWT);
+        return pixNumber(x, y, _matrixConfig, _matrixType, _width, _height, _matrixW);
+    }
 
-        if (_matrixType || !(thisY % 2)) 
-			return (thisY * _matrixW + thisX);					// если чётная строка
-        else 
-			return (thisY * _matrixW + _matrixW - thisX - 1);   // если нечётная строка
+    // обратно к getPixNumber: координаты по положению в цепочке (thisX - в ряду, thisY - ряд)
+    void getPixXY(int thisX, int thisY, int &x, int &y) {
+        if (mW) pixXY(thisX, thisY, x, y, _cfgT, mW, mH);
+        else pixXY(thisX, thisY, x, y, _matrixConfig, _width, _height);
     }
 
     void set(int x, int y, mData color) {
-        if (x * y >= amount || x < 0 || y < 0 || x >= _width || y >= _height) return;
-        leds[getPixNumber(x, y)] = color;
+#ifdef MYARDUINO_HOST
+        hostTick(mW ? MLED_HOST_CK_SET_T : MLED_HOST_CK_SET);
+#endif
+        if (x * y >= amount || x < 0 || y < 0 || x >= mWidth() || y >= mHeight()) return;
+        set(getPixNumber(x, y), color);
     }
 
     mData get(int x, int y) {
@@ -212,8 +455,7 @@ public:
     }
 
     void fade(int x, int y, byte val) {
-        int pix = getPixNumber(x, y);
-        leds[pix] = getFade(leds[pix], val);
+        fade(getPixNumber(x, y), val);
     }
 
     void drawBitmap8(int X, int Y, const uint8_t *frame, int width, int height) {
@@ -232,24 +474,95 @@ public:
         set(x + X, y + Y, pgm_read_dword(&frame[x + (height - 1 - y) * width]));
     }
 
+    // линии и прямоугольники: вдоль рядов цепочки заливка идёт подряд по leds[]
+    void hline(int x, int y, int len, mData color) {
+        if (y < 0 || y >= mHeight() || !clip(x, len, mWidth())) return;
+        if (linesAlongX()) lineFill(y, x, len, color);
+        else for (int i = 0; i < len; i++) set(getPixNumber(x + i, y), color);
+    }
+
+    void vline(int x, int y, int len, mData color) {
+        if (x < 0 || x >= mWidth() || !clip(y, len, mHeight())) return;
+        if (!linesAlongX()) lineFill(x, y, len, color);
+        else for (int i = 0; i < len; i++) set(getPixNumber(x, y + i), color);
+    }
+
+    void fillRect(int x, int y, int w, int h, mData color) {
+        if (!clip(x, w, mWidth()) || !clip(y, h, mHeight())) return;
+        if (linesAlongX()) for (int i = 0; i < h; i++) lineFill(y + i, x, w, color);
+        else for (int i = 0; i < w; i++) lineFill(x + i, y, h, color);
+    }
+
+    // скопировать len цветов из data в строку y начиная с x
+    void blitRow(int x, int y, const mData *data, int len) {
+        if (y < 0 || y >= mHeight()) return;
+        int from = x;
+        if (!clip(x, len, mWidth())) return;
+        data += x - from;
+        if (linesAlongX()) {
+            int n = getPixNumber(x, y);
+            int8_t step = lineStep(y);
+            mData *p = &leds[n];
+            for (int i = 0; i < len; i++, p += step) {
+#ifdef MLED_CURRENT_TRACK
+                _chSum += chSum(data[i]) - chSum(*p);
+#endif
+                *p = data[i];
+            }
+            markDirty((step > 0) ? n + len - 1 : n);
+        } else {
+            for (int i = 0; i < len; i++) set(getPixNumber(x + i, y), data[i]);
+        }
+    }
+
+    // сдвинуть картинку на dx dy, освободившееся место залить color
+    // вдоль рядов цепочки - memmove внутри ряда, поперёк - копирование рядов целиком
+    void scroll(int dx, int dy, mData color = 0) {
+        bool ax = linesAlongX();
+        int along = ax ? dx : dy;
+        int across = ax ? dy : dx;
+        int len = ax ? mWidth() : mHeight();
+        int lines = ax ? mHeight() : mWidth();
+        if (along) for (int q = 0; q < lines; q++) lineShift(q, along, len, color);
+        if (across > 0) for (int q = lines - 1; q >= 0; q--) lineCopy(q, q - across, lines, len, color);
+        else if (across < 0) for (int q = 0; q < lines; q++) lineCopy(q, q - across, lines, len, color);
+        recalcCurrent();
+        markDirty(mWidth() * mHeight() - 1);
+    }
+
     // ============================================== УТИЛИТЫ ==============================================
     void setMaxCurrent(int ma) {
         _maxCurrent = ma;
     }
 
+    // пересчитать сумму каналов для MLED_CURRENT_TRACK (после прямой записи в leds[])
+    void recalcCurrent() {
+#ifdef MLED_CURRENT_TRACK
+        _chSum = 0;
+        trackRange(0, amount - 1, true);
+#endif
+    }
+
     uint8_t correctBright(uint8_t bright) {
         long sum = 0;
+#if defined(MLED_CURRENT_TRACK) && defined(MLED_DOUBLE_BUFFER)
+        sum = ((uint32_t)_chSumFront * (bright + 1)) >> 8;
+#elif defined(MLED_CURRENT_TRACK)
+        sum = ((uint32_t)_chSum * (bright + 1)) >> 8;   // сумма fade8 по всем каналам (без округления каждого)
+#else
+        const mData *out = outBuf();
         for (int i = 0; i < amount; i++) {
-            sum += fade8R(leds[i], bright);
-            sum += fade8G(leds[i], bright);
-            sum += fade8B(leds[i], bright);
+            sum += fade8R(out[i], bright);
+            sum += fade8G(out[i], bright);
+            sum += fade8B(out[i], bright);
         }
+#endif
 
         sum = ((long)sum >> 8) * oneLedMax / 3;         // текущий "активный" ток ленты
         int idle = (long)oneLedIdle * amount / 1000;      // холостой ток ленты
         if (sum == 0) return bright;
         if ((sum + idle) < _maxCurrent) return bright;      // ограничения нет
-        else return ((float)(_maxCurrent - idle) * bright / sum); // пересчёт яркости
+        else return ((long)(_maxCurrent - idle) * bright / sum); // пересчёт яркости
     }
 
     // ============================================== ВЫВОД ==============================================
@@ -270,15 +583,301 @@ public:
     }
 
     void show() {
+#ifdef MLED_USART_SPI
+        if (chip != LED_APA102 && chip != LED_APA102_SPI) {
+            while (usartBusy());                    // прошлый кадр и остаток его паузы ресета
+            _showBright = _bright;
+        } else
+#endif
         begin();
         if (_maxCurrent != 0 && amount != 0) _showBright = correctBright(_bright);
-        if (CHIP4COLOR) for (int i = 0; i < amount; i++) send(leds[i], white[i]);
-        else for (int i = 0; i < amount; i++) send(leds[i]);
+        int len = amount;
+#ifdef MLED_PARTIAL_SHOW
+        if (_showBright == _lastBright && chip != LED_APA102 && chip != LED_APA102_SPI) len = _dirty;
+        _lastBright = _showBright;
+        _dirty = 0;
+#endif
+        const mData *out = outBuf();
+#ifdef MLED_USART_SPI
+        if (chip != LED_APA102 && chip != LED_APA102_SPI) {
+            usartStart(out, len, len);
+            return;
+        }
+#endif
+#ifdef MLED_STAGE_CHUNK
+        if (chip != LED_APA102 && chip != LED_APA102_SPI) showStaged(len);
+        else
+#endif
+        sendPixels([&](int i, byte &w) {
+            if (CHIP4COLOR) w = white[i];
+            return out[i];
+        }, len);
+        end();
+    }
+
+    // вывод без буфера: цвет каждого диода считает f(номер, x, y, frame) во время вывода предыдущего
+    // для ленты x = номер, y = 0. Можно использовать с amount = 0 и указать count. Белый WS6812 задаёт
+    // f(номер, x, y, frame, byte &white), с четырьмя аргументами белый 0. Время f прибавляется к паузе
+    // LOW после первого байта диода: до ~25 тактов (16 МГц) пауза в пределах TLL 5 мкс, дольше - только
+    // короче ресета ленты
+    template <class F>
+    void showGenerated(F f, uint16_t frame = 0, int count = amount) {
+        int col = 0, row = 0;           // положение в цепочке: номер в ряду и ряд
+        begin();
+        sendPixels([&](int i, byte &w) {
+            int x = i, y = 0;
+            if (mWidth()) {
+                int thisX = (_matrixType || !(row & 1)) ? col : (_matrixW - col - 1);
+                getPixXY(thisX, row, x, y);
+                if (++col >= _matrixW) {
+                    col = 0;
+                    row++;
+                }
+            }
+            w = 0;
+            return genColor(f, i, x, y, frame, w, 0);
+        }, count);
         end();
     }
 
+    // конвейер: render(from, to) рисует диоды from..to-1 в leds[], с MLED_USART_SPI кусок уходит в ленту
+    // сразу после отрисовки, а следующий рисуется во время его передачи. Если кусок рисуется дольше,
+    // чем передаётся предыдущий, в ленте пауза - она должна быть короче ресета ленты (выбрать chunk).
+    // Кольцо дозаполняется только между кусками: один кусок рисовать не дольше MLED_USART_RING * 3 мкс.
+    // Ограничение тока здесь не работает. Без MLED_USART_SPI - все куски, затем show().
+    // С MLED_DOUBLE_BUFFER как swap() + show(): выводится нарисованный в leds кадр, после вызова
+    // он лежит в front, а leds указывает на прошлый front
+    template <class F>
+    void showPipelined(F render, int chunk) {
+#ifdef MLED_USART_SPI
+        if (chip != LED_APA102 && chip != LED_APA102_SPI) {
+            while (usartBusy());
+            _showBright = _bright;
+            const mData *buf = leds;
+            int to = (chunk < amount) ? chunk : amount;
+            render(0, to);
+            usartStart(buf, amount, to);
+            while (to < amount) {
+                int from = to;
+                to = (from + chunk < amount) ? from + chunk : amount;
+                render(from, to);
+                usartRelease(buf + to);
+            }
+#ifdef MLED_DOUBLE_BUFFER
+            swapBuffers();              // кадр ещё уходит, он уже front - рисовать дальше в leds можно
+#endif
+#ifdef MLED_PARTIAL_SHOW
+            _lastBright = _showBright;
+            _dirty = 0;
+#endif
+            return;
+        }
+#endif
+        for (int from = 0; from < amount; from += chunk) render(from, (from + chunk < amount) ? from + chunk : amount);
+#ifdef MLED_DOUBLE_BUFFER
+        swap();
+#endif
+        show();
+    }
+
+#ifdef MLED_STAGE_CHUNK
+    // вывод буфера кусками: яркость и порядок цветов считаются заранее, отправка без пауз между байтами
+    // CLI_LOW и CLI_AVER запрещают прерывания как и без буфера (на байт / на диод), кусок тогда
+    // уходит по байту / по диоду, пауза между ними - вызов sendRawBuf
+    void showStaged(int len) {
+        const uint8_t bpl = (CHIP4COLOR) ? 4 : 3;
+        uint8_t buf[MLED_STAGE_CHUNK * ((CHIP4COLOR) ? 4 : 3)];
+        const mData *out = outBuf();
+        int i = 0;
+        while (i < len) {
+            uint8_t *p = buf;
+            int last = i + MLED_STAGE_CHUNK;
+            if (last > len) last = len;
+            for (; i < last; i++) {
+#ifdef MYARDUINO_HOST
+                hostTick(MLED_HOST_CK_STAGE + MLED_HOST_CK_UNPACK);
+#endif
+                p[(order >> 4) & 0b11] = fade8R(out[i], _showBright);
+                p[(order >> 2) & 0b11] = fade8G(out[i], _showBright);
+                p[order & 0b11] = fade8B(out[i], _showBright);
+                if (CHIP4COLOR) p[3] = fade8(white[i], _showBright);
+                p += bpl;
+            }
+            if (isr == CLI_LOW || isr == CLI_AVER) {
+                // запрет прерываний как без буфера: на байт (CLI_LOW) или на диод (CLI_AVER)
+                uint8_t step = (isr == CLI_LOW) ? 1 : bpl;
+                for (uint8_t *b = buf; b < p; b += step) {
+                    sregSave = SREG;
+                    cli();
+                    sendRawBuf(b, step);
+                    SREG = sregSave;
+                }
+            } else {
+                sendRawBuf(buf, p - buf);
+            }
+            if (uptime && (isr == CLI_AVER || isr == CLI_HIGH)) systemUptimePoll();  // пнуть миллисы
+        }
+    }
+
+    // отправить len готовых байт одним циклом (WS281x/WS6812)
+    // между байтами пауза 8 тактов в LOW: SBIW + BREQ + LD + RJMP + LDI
+    // asm ещё не собирался avr-gcc (ограничения "+w"/"+z", r19/r20), проверено только модель хоста
+    void sendRawBuf(const uint8_t *buf, uint16_t len) {
+        if (!len) return;
+#ifdef MYARDUINO_HOST
+        hostTick(MLED_HOST_CK_CHUNK);
+        for (uint16_t i = 0; i < len; i++) {
+            if (i) hostTick(8);
+            hostSendRaw(buf[i]);
+        }
+#else
+        uint8_t data;
+        switch (chip) {
+        case LED_WS2811:
+            asm volatile
+            (
+            "LD %[DATA], Z+        \n\t"  // Первый байт
+            "_BYTE_START_%=:       \n\t"  // Начало байта
+            "LDI r19, 8            \n\t"  // Загружаем в счетчик циклов 8
+            "_LOOP_START_%=:       \n\t"  // Начало основного цикла
+            "ST X, %[SET_H]        \n\t"  // Устанавливаем на выходе HIGH
+#if(F_CPU == 32000000UL)
+            "RJMP .+0              \n\t"  // (LGT8 32MHZ) два дополнительных NOP
+#endif
+            "SBRS %[DATA], 7       \n\t"  // Если текущий бит установлен - пропуск след. инстр.
+            "ST X, %[SET_L]        \n\t"  // Устанавливаем на выходе LOW
+            "LSL  %[DATA]          \n\t"  // Двигаем данные влево на один бит
+#if(F_CPU == 32000000UL)
+            "LDI r20, 14           \n\t"
+#else
+            "LDI r20, 4            \n\t"
+#endif
+            "_DELAY_LOOP_%=:       \n\t"  // Цикл задержки
+            "DEC r20               \n\t"  // 1CK декремент
+            "BRNE _DELAY_LOOP_%=   \n\t"  // 2CK переход
+            "NOP                   \n\t"  // 1CK NOP
+            "ST X, %[SET_L]        \n\t"  // Устанавливаем на выходе LOW
+            "DEC r19               \n\t"  // Декремент счетчика циклов
+            "BRNE  _LOOP_START_%=  \n\t"  // Переход на новый цикл, если счетчик не иссяк
+            "SBIW %[COUNT], 1      \n\t"  // 2CK байтов осталось
+            "BREQ _END_%=          \n\t"  // 1CK все отправлены
+            "LD %[DATA], Z+        \n\t"  // 2CK следующий байт
+            "RJMP _BYTE_START_%=   \n\t"  // 2CK
+            "_END_%=:              \n\t"
+            :[DATA] "=&r" (data),
+            [COUNT] "+w" (len),
+            "+z" (buf)
+            :[SET_H] "r" (_mask_h),
+            [SET_L] "r" (_mask_l),
+            "x" (_dat_port)
+            :"r19","r20","memory"
+            );
+            break;
+        case LED_WS2812:
+        case LED_WS2813:
+        case LED_WS2815:
+        case LED_WS2818:
+        case LED_WS6812:
+            asm volatile
+            (
+            "LD %[DATA], Z+        \n\t"  // Первый байт
+            "_BYTE_START_%=:       \n\t"  // Начало байта
+            "LDI r19, 8            \n\t"  // Загружаем в счетчик циклов 8
+            "_LOOP_START_%=:       \n\t"  // Начало основного цикла
+            "ST X, %[SET_H]        \n\t"  // Устанавливаем на выходе HIGH
+#if(F_CPU == 32000000UL)
+            "RJMP .+0              \n\t"  // (LGT8 32MHZ) два дополнительных NOP
+#elif(F_CPU == 16000000UL)
+            "NOP                   \n\t"  // T0H 4 такта (250 нс)
+#endif
+            "SBRS %[DATA], 7       \n\t"  // Если текущий бит установлен - пропуск след. инстр.
+            "ST X, %[SET_L]        \n\t"  // Устанавливаем на выходе LOW
+            "LSL  %[DATA]          \n\t"  // Двигаем данные влево на один бит
+#if(F_CPU == 32000000UL)
+            "LDI r20, 9            \n\t"
+            "_DELAY_LOOP_%=:       \n\t"  // Цикл задержки
+            "DEC r20               \n\t"  // 1CK декремент
+            "BRNE _DELAY_LOOP_%=   \n\t"  // 2CK переход
+#elif(F_CPU == 16000000UL)
+            "RJMP .+0              \n\t"  // 4CK задержка, T1H 11 тактов (687 нс)
+            "RJMP .+0              \n\t"
+#endif
+            "NOP                   \n\t"  // 1CK NOP
+            "ST X, %[SET_L]        \n\t"  // Устанавливаем на выходе LOW
+#if(F_CPU == 16000000UL)
+            "RJMP .+0              \n\t"  // 3CK, TL после 1 - 8 тактов (SK6812 от 450 нс)
+            "NOP                   \n\t"
+#endif
+            "DEC r19               \n\t"  // Декремент счетчика циклов
+            "BRNE  _LOOP_START_%=  \n\t"  // Переход на новый цикл, если счетчик не иссяк
+            "SBIW %[COUNT], 1      \n\t"  // 2CK байтов осталось
+            "BREQ _END_%=          \n\t"  // 1CK все отправлены
+            "LD %[DATA], Z+        \n\t"  // 2CK следующий байт
+            "RJMP _BYTE_START_%=   \n\t"  // 2CK
+            "_END_%=:              \n\t"
+            :[DATA] "=&r" (data),
+            [COUNT] "+w" (len),
+            "+z" (buf)
+            :[SET_H] "r" (_mask_h),
+            [SET_L] "r" (_mask_l),
+            "x" (_dat_port)
+            :"r19","r20","memory"
+            );
+            break;
+        default:
+            for (uint16_t i = 0; i < len; i++) sendRaw(buf[i]);
+            break;
+        }
+#endif
+    }
+#endif
+
+    // отправить count диодов потоком (между begin и end), цвет диода i - get(i, white), белый только
+    // у WS6812. Диод i + 1 читается и готовится в паузах LOW между байтами диода i, по каналу на паузу,
+    // поэтому пауза между диодами - только цикл и вызов sendRaw, а не весь send(). get вызывается
+    // один раз на диод и заранее (во время вывода предыдущего)
+    template <class G>
+    void sendPixels(G get, int count) {
+        if (count <= 0) return;
+        byte w = 0;
+        mData c = get(0, w);
+        byte cur[4];
+        cur[0] = pixByte(c, w, 0);
+        cur[1] = pixByte(c, w, 1);
+        cur[2] = pixByte(c, w, 2);
+        if (CHIP4COLOR) cur[3] = pixByte(c, w, 3);
+        for (int i = 0; i < count; i++) {
+            if (isr == CLI_AVER) {    // Средний приоритет, текущий диод однозначно будет обновлен
+                sregSave = SREG;
+                cli();
+            }
+            if (chip == LED_APA102 || chip == LED_APA102_SPI) sendRaw(255); // старт байт SPI лент
+            sendRaw(cur[0]);
+            if (i + 1 < count) {
+#ifdef MYARDUINO_HOST
+                hostTick(MLED_HOST_CK_PIXEL);
+#endif
+                c = get(i + 1, w);
+            }
+            cur[0] = pixByte(c, w, 0);
+            sendRaw(cur[1]);
+            cur[1] = pixByte(c, w, 1);
+            sendRaw(cur[2]);
+            cur[2] = pixByte(c, w, 2);
+            if (CHIP4COLOR) {
+                sendRaw(cur[3]);
+                cur[3] = pixByte(c, w, 3);
+            }
+            if (isr == CLI_AVER) SREG = sregSave;   // Средний приоритет, вернуть прерывания
+            if (uptime && (isr == CLI_AVER || isr == CLI_HIGH)) systemUptimePoll();  // пнуть миллисы
+        }
+    }
+
     void send(mData color, byte thisWhite = 0) {
         uint8_t data[3];
+#ifdef MYARDUINO_HOST
+        hostTick(MLED_HOST_CK_SEND + MLED_HOST_CK_UNPACK);
+#endif
         // компилятор посчитает сдвиги
         data[(order >> 4) & 0b11] = fade8R(color, _showBright);
         data[(order >> 2) & 0b11] = fade8G(color, _showBright);
@@ -300,13 +899,19 @@ public:
         if (uptime && (isr == CLI_AVER || isr == CLI_HIGH)) systemUptimePoll();  // пнуть миллисы
     }
 
-    void sendRaw(byte data) {        
+    void sendRaw(byte data) {
+#ifdef MYARDUINO_HOST
+        hostTick(MLED_HOST_CK_BYTE);
+#endif
         if (isr == CLI_LOW) {             // Низкий приоритет, текущий байт однозначно будет отправлен
             sregSave = SREG;
             cli();
         }
         switch (chip) {
         case LED_WS2811:
+#ifdef MYARDUINO_HOST
+            hostSendRaw(data);
+#else
             asm volatile
             (
             "LDI r19, 8          \n\t"     // Загружаем в счетчик циклов 8
@@ -341,12 +946,16 @@ public:
             "x" (_dat_port)
             :"r19","r20"
             );
+#endif
             break;
         case LED_WS2812:
         case LED_WS2813:
         case LED_WS2815:
         case LED_WS2818:
         case LED_WS6812:
+#ifdef MYARDUINO_HOST
+            hostSendRaw(data);
+#else
             asm volatile
             (
             "LDI 19, 8          \n\t"     // Загружаем в счетчик циклов 8
@@ -354,24 +963,29 @@ public:
             "ST X, %[SET_H]     \n\t"     // Устанавливаем на выходе HIGH
 #if(F_CPU == 32000000UL) 
             "RJMP .+0  \n\t"              // (LGT8 32MHZ) два дополнительных NOP
+#elif(F_CPU == 16000000UL)
+            "NOP       \n\t"              // T0H 4 такта (250 нс)
 #endif 
             "SBRS %[DATA], 7    \n\t"     // Если текущий бит установлен - пропуск след. инстр.
             "ST X, %[SET_L]     \n\t"     // Устанавливаем на выходе LOW
             "LSL  %[DATA]       \n\t"     // Двигаем данные влево на один бит
             //-----------------------------------------------------------------------------------------
-#if(F_CPU > 8000000UL)
 #if(F_CPU == 32000000UL)                    // (LGT8) delay 29 тактов, 9 цикла по 3CK + загрузка 1CK + NOP  
             "LDI r20, 9            \n\t"
-#elif(F_CPU == 16000000UL)                    // delay 8 тактов, 2 цикла по 3CK + загрузка 1CK + NOP
-            "LDI r20, 3            \n\t"
-#endif
             "_DELAY_LOOP_%=:    \n\t"     // Цикл задержки
             "DEC r20               \n\t"     // 1CK декремент
             "BRNE _DELAY_LOOP_%=\n\t"     // 2CK переход
+#elif(F_CPU == 16000000UL)                    // delay 5 тактов, 2 x RJMP + NOP: T1H 11 тактов (687 нс)
+            "RJMP .+0              \n\t"
+            "RJMP .+0              \n\t"
 #endif
             "NOP                   \n\t"  // 1CK NOP
             //-----------------------------------------------------------------------------------------
             "ST X, %[SET_L]        \n\t"  // Устанавливаем на выходе LOW
+#if(F_CPU == 16000000UL)                    // TL после 1: 3CK + DEC/BRNE + ST = 8 тактов (SK6812 от 450 нс)
+            "RJMP .+0              \n\t"
+            "NOP                   \n\t"
+#endif
             "DEC r19               \n\t"  // Декремент счетчика циклов
             "BRNE  _LOOP_START_%=  \n\t"  // Переход на новый цикл, если счетчик не иссяк
             :
@@ -381,13 +995,20 @@ public:
             "x" (_dat_port)
             :"r19","r20"
             );
+#endif
             break;
         case LED_APA102:
             for (uint8_t _loop_count = 0; _loop_count < 8; _loop_count++)  {
+#ifdef MYARDUINO_HOST
+                hostPortWrite(_dat_port, (data & (1 << 7)) ? (*_dat_port | _dat_mask) : (*_dat_port & ~_dat_mask));
+                hostPortWrite(_clk_port, *_clk_port | _clk_mask);
+                hostPortWrite(_clk_port, *_clk_port & ~_clk_mask);
+#else
                 if (data & (1 << 7)) *_dat_port |= _dat_mask;
                 else *_dat_port &= ~_dat_mask;
                 *_clk_port |= _clk_mask;
                 *_clk_port &= ~_clk_mask;
+#endif
                 data <<= 1;
             }
             break;
@@ -408,8 +1029,484 @@ public:
 #endif
     }
 
+#ifdef MLED_USART_SPI
+    // обработчик прерывания UDRE (вызывается из MLED_USART_ISR): байт SPI (2 бита ленты) из кольца в UDR0.
+    // Счёт тактов вручную по коду avr-gcc -Os (strip - глобальный объект, поля по LDS/STS), компилятора
+    // AVR для проверки здесь нет: вход в прерывание 4 + JMP 3, пролог r0 r1 SREG r24 r25 r30 r31 16,
+    // LDS LDS CP BREQ 6, адрес в Z 4, LD 2, STS UDR0 2 (запись на ~35-м такте), индекс 4,
+    // эпилог 15, RETI 4 - около 61 такта. Байт SPI уходит за 48 тактов (16 МГц) / 96 (32 МГц)
+    void usartISR() {
+        uint8_t t = _uTail;
+        if (t == _uHead) {                          // кольцо пусто: конец кадра или основной цикл не успел
+            UCSR0B &= ~_BV(UDRIE0);
+            _uStall = true;
+            return;
+        }
+#ifdef MYARDUINO_HOST
+        hostUsartUdr(_uRing[t]);
+#else
+        UDR0 = _uRing[t];
+#endif
+        _uTail = (t + 1) & (MLED_USART_RING - 1);
+    }
+
+    // идёт передача кадра (с паузой ресета в конце), заодно дозаполняет кольцо.
+    // Когда кадр ушёл - TXD возвращается к пину с LOW
+    bool usartBusy() {
+        if (!(UCSR0B & _BV(TXEN0))) return false;
+        usartFill();
+#ifdef MYARDUINO_HOST
+        hostTick(MLED_HOST_CK_POLL);
+        hostUsartRun();
+#endif
+        if (_uLeft || _uLatch || _uTail != _uHead) return true;
+        if ((UCSR0B & _BV(UDRIE0)) || !(UCSR0A & _BV(TXC0))) return true;
+        UCSR0B = 0;
+        return false;
+    }
+#endif
+
+#ifdef MYARDUINO_HOST
+    // хост: записать leds[] (цвета без яркости) кадром в лог hostLogWrite() - эталоны эффектов,
+    // сравнение с hostLogCompare(). false - ошибка файла
+    bool hostLog(const char *file, int count = amount) {
+        HostPixel pix[amount];
+        if (count > amount) count = amount;
+        for (int i = 0; i < count; i++) {
+            pix[i].r = getR(leds[i]);
+            pix[i].g = getG(leds[i]);
+            pix[i].b = getB(leds[i]);
+            pix[i].w = 0;
+        }
+        return hostLogWrite(file, pix, count, 3);
+    }
+
+#ifdef MLED_CURRENT_TRACK
+    // хост: отслеживаемая сумма каналов заднего (leds) или переднего (front) буфера - для теста
+    uint32_t hostChSum(bool ofFront = false) {
+#ifdef MLED_DOUBLE_BUFFER
+        if (ofFront) return _chSumFront;
+#else
+        (void)ofFront;
+#endif
+        return _chSum;
+    }
+#endif
+#endif
+
+    // microLEDParallel выводит буфер сам, через поля вывода этого класса
+    template<int, uint8_t, int8_t, M_chip, M_order, M_ISR, uint8_t, uint8_t, uint8_t, M_type, M_connection, M_dir>
+    friend class microLEDParallel;
+    // microLEDPalette берёт размер матрицы отсюда (mWidth/mHeight)
+    template<int, uint8_t, int8_t, int8_t, M_chip, M_order, M_ISR, uint8_t>
+    friend class microLEDPalette;
+
+private:
+    // цвет для showGenerated: f с белым (5 аргументов) предпочтительнее, иначе f(i, x, y, frame)
+    template <class F>
+    static auto genColor(F &f, int i, int x, int y, uint16_t frame, byte &w, int) -> decltype(f(i, x, y, frame, w)) {
+        return f(i, x, y, frame, w);
+    }
+    template <class F>
+    static auto genColor(F &f, int i, int x, int y, uint16_t frame, byte &, long) -> decltype(f(i, x, y, frame)) {
+        return f(i, x, y, frame);
+    }
+
+    // байт на позиции pos в посылке диода (порядок цветов, белый на 3), яркость _showBright
+    inline byte pixByte(mData c, byte w, uint8_t pos) __attribute__((always_inline)) {
+#ifdef MYARDUINO_HOST
+        hostTick(MLED_HOST_CK_CHANNEL + MLED_HOST_CK_UNPACK / 3);  // getR/G/B у fade8 канала
+#endif
+        if (pos == ((order >> 4) & 0b11)) return fade8R(c, _showBright);
+        if (pos == ((order >> 2) & 0b11)) return fade8G(c, _showBright);
+        if (pos == (order & 0b11)) return fade8B(c, _showBright);
+        return fade8(w, _showBright);
+    }
+
+#ifdef MYARDUINO_HOST
+    // хост: побитовая модель asm вывода WS281x с подсчётом тактов
+    // ext - доп. такты после HIGH (RJMP на LGT8 32 МГц, NOP у WS2812 16 МГц), dly - задержка
+    // (LDI + DEC/BRNE или RJMP), post - такты после второго LOW (WS2812 16 МГц)
+    void hostSendRaw(byte data) {
+        uint8_t ext, dly, post = 0;
+        if (chip == LED_WS2811) {
+            ext = (F_CPU == 32000000UL) ? 2 : 0;
+            dly = (F_CPU == 32000000UL) ? 3 * 14 : 3 * 4;
+        } else if (F_CPU == 32000000UL) {
+            ext = 2;
+            dly = 3 * 9;
+        } else {
+            ext = 1;
+            dly = 4;
+            post = 3;
+        }
+        for (uint8_t i = 0; i < 8; i++) {
+            hostTick(2);                                    // ST HIGH
+            hostPortWrite(_dat_port, _mask_h);
+            if (data & (1 << 7)) {
+                hostTick(ext + 2 + 1 + dly + 1 + 2);        // SBRS(пропуск), LSL, задержка, NOP, ST LOW
+                hostPortWrite(_dat_port, _mask_l);
+            } else {
+                hostTick(ext + 1 + 2);                      // SBRS, ST LOW
+                hostPortWrite(_dat_port, _mask_l);
+                hostTick(1 + dly + 1 + 2);                  // LSL, задержка, NOP, ST LOW
+                hostPortWrite(_dat_port, _mask_l);
+            }
+            hostTick(post + ((i < 7) ? 3 : 2));             // DEC + BRNE
+            data <<= 1;
+        }
+    }
+#endif
+
+    // матрица из шаблона
+    static const uint8_t _cfgT = (uint8_t)mConn | ((uint8_t)mDir << 2);
+    static const uint8_t _mWT = (_cfgT == 4 || _cfgT == 13 || _cfgT == 14 || _cfgT == 7) ? mH : mW;
+
+    // общий расчёт для getPixNumber/getPixXY: с константами из шаблона сворачивается компилятором
+    static inline __attribute__((always_inline))
+    uint16_t pixNumber(int x, int y, uint8_t cfg, uint8_t type, uint8_t w, uint8_t h, uint8_t rowW) {
+        int thisX, thisY;
+        switch (cfg) {
+        default:
+        case 0:   thisX = x;          thisY = y;          break;
+        case 4:   thisX = y;          thisY = x;          break;
+        case 1:   thisX = x;          thisY = (h - y - 1);  break;
+        case 13:  thisX = (h - y - 1);  thisY = x;          break;
+        case 10:  thisX = (w - x - 1); thisY = (h - y - 1);  break;
+        case 14:  thisX = (h - y - 1);  thisY = (w - x - 1); break;
+        case 11:  thisX = (w - x - 1); thisY = y;          break;
+        case 7:   thisX = y;          thisY = (w - x - 1); break;
+        }
+
+        if (type || !(thisY & 1)) 
+			return (thisY * rowW + thisX);					// если чётная строка
+        else 
+			return (thisY * rowW + rowW - thisX - 1);       // если нечётная строка
+    }
+
+    static inline __attribute__((always_inline))
+    void pixXY(int thisX, int thisY, int &x, int &y, uint8_t cfg, uint8_t w, uint8_t h) {
+        switch (cfg) {
+        default:
+        case 0:   x = thisX;          y = thisY;          break;
+        case 4:   x = thisY;          y = thisX;          break;
+        case 1:   x = thisX;          y = h - thisY - 1;  break;
+        case 13:  x = thisY;          y = h - thisX - 1;  break;
+        case 10:  x = w - thisX - 1;  y = h - thisY - 1;  break;
+        case 14:  x = w - thisY - 1;  y = h - thisX - 1;  break;
+        case 11:  x = w - thisX - 1;  y = thisY;          break;
+        case 7:   x = w - thisY - 1;  y = thisX;          break;
+        }
+    }
+
+#ifdef MLED_USART_SPI
+    // передать len диодов из buf, готовы первые ready (остальные - через usartRelease)
+    void usartStart(const mData *buf, int len, int ready) {
+        _uPtr = buf;
+        _uEnd = buf + ready;
+        _uWhite = white;
+        _uLeft = len;
+        _uLatch = len ? MLED_USART_LATCH : 0;
+        _uHead = _uTail = 0;
+        _uStall = false;
+        if (!len) return;
+#ifdef MYARDUINO_HOST
+        hostUsartBegin();
+#endif
+        usartFill();                                // кольцо до отказа, пока передача стоит
+        usartClearTxc();
+        UCSR0B = _BV(TXEN0) | _BV(UDRIE0);
+#ifdef MYARDUINO_HOST
+        _hostEnable = hostCycles;
+        hostUsartRun();
+#endif
+    }
+
+    // сбросить флаг окончания передачи TXC0 (запись 1, на хосте - обычный бит)
+    void usartClearTxc() {
+#ifdef MYARDUINO_HOST
+        UCSR0A &= ~_BV(TXC0);
+#else
+        UCSR0A = _BV(TXC0);
+#endif
+    }
+
+    // конвейер: диоды до end нарисованы, продолжить передачу
+    void usartRelease(const mData *end) {
+        _uEnd = end;
+        usartFill();
+    }
+
+    // основной цикл: готовые диоды (яркость, порядок, кодирование) и нули паузы ресета в кольцо.
+    // Если прерывание остановилось на пустом кольце - запустить снова
+    void usartFill() {
+        static const uint8_t sym[4] = { 0x88, 0x8C, 0xC8, 0xCC };  // 2 бита ленты -> байт SPI
+        const uint8_t bpl = (CHIP4COLOR) ? 16 : 12;
+        for (;;) {
+#ifdef MYARDUINO_HOST
+            hostUsartRun();                         // прерывания до этого такта
+#endif
+            uint8_t h = _uHead;
+            uint8_t space = (_uTail - h - 1) & (MLED_USART_RING - 1);
+            if (_uLeft) {
+                if (space < bpl || _uPtr >= _uEnd) break;
+#ifdef MYARDUINO_HOST
+                hostTick(MLED_HOST_CK_USART_PIXEL + MLED_HOST_CK_UNPACK);
+#endif
+                uint8_t pix[4];
+                mData color = *_uPtr++;
+                pix[(order >> 4) & 0b11] = fade8R(color, _showBright);
+                pix[(order >> 2) & 0b11] = fade8G(color, _showBright);
+                pix[order & 0b11] = fade8B(color, _showBright);
+                if (CHIP4COLOR) pix[3] = fade8(*_uWhite++, _showBright);
+                for (uint8_t c = 0; c < bpl / 4; c++) {
+                    uint8_t v = pix[c];
+                    for (uint8_t k = 0; k < 4; k++, v <<= 2) {
+                        _uRing[h] = sym[v >> 6];
+                        h = (h + 1) & (MLED_USART_RING - 1);
+                    }
+                }
+                _uLeft--;
+            } else if (_uLatch) {
+                if (!space) break;
+                if (space > _uLatch) space = _uLatch;
+#ifdef MYARDUINO_HOST
+                hostTick(MLED_HOST_CK_USART_ZERO * space);
+#endif
+                _uLatch -= space;
+                while (space--) {
+                    _uRing[h] = 0;
+                    h = (h + 1) & (MLED_USART_RING - 1);
+                }
+            } else break;
+            _uHead = h;                             // байты видны прерыванию только целым диодом
+            if (_uStall) {
+                uint8_t sreg = SREG;
+                cli();
+                _uStall = false;
+                usartClearTxc();                    // флаг окончания от паузы не считать
+                UCSR0B |= _BV(UDRIE0);
+                SREG = sreg;
+#ifdef MYARDUINO_HOST
+                _hostEnable = hostCycles;
+#endif
+            }
+        }
+#ifdef MYARDUINO_HOST
+        hostUsartRun();
+#endif
+    }
+
+#ifdef MYARDUINO_HOST
+    // хост: модель времени USART и прерывания. Байт в UDR0 уходит в сдвиговый регистр, когда тот
+    // свободен (_hostWire), тогда же UDR0 снова пуст и приходит следующее UDRE (_hostFire).
+    // Прерывание стоит MLED_HOST_CK_USART_ISR тактов процессора, запись UDR0 на MLED_HOST_CK_USART_UDR.
+    // Если запись позже конца прошлого байта - пауза в ленте (underrun). Прерывания выполняются
+    // по времени до текущего такта основного цикла, их такты прибавляются к нему
+    void hostUsartBegin() {
+        memset(&_hostStats, 0, sizeof(_hostStats));
+        _hostStats.start = hostCycles;
+        _hostWire = _hostFire = _hostIsrEnd = 0;
+    }
+
+    void hostUsartUdr(uint8_t data) {
+        uint64_t start = hostCycles;
+        if (_hostStats.bytes && start > _hostWire) {
+            uint64_t gap = start - _hostWire;
+            _hostStats.underruns++;
+            _hostStats.gapCycles += gap;
+            if (gap > _hostStats.gapMax) _hostStats.gapMax = gap;
+        }
+        if (start < _hostWire) start = _hostWire;   // ждёт в UDR0, пока сдвигается прошлый байт
+        uint64_t cpu = hostCycles;
+        hostCycles = start;
+        hostUsartSpiWrite(data);
+        _hostWire = hostCycles;
+        hostCycles = cpu;
+        _hostFire = start;                          // UDR0 снова пуст
+        _hostStats.bytes++;
+    }
+
+    void hostUsartRun() {
+        uint64_t cpu = hostCycles;
+        while (UCSR0B & _BV(UDRIE0)) {
+            uint64_t t = _hostFire;
+            if (t < _hostEnable) t = _hostEnable;
+            if (t < _hostIsrEnd + 1) t = _hostIsrEnd + 1;   // после RETI - одна инструкция цикла
+            if (t > cpu) break;
+            hostCycles = t + MLED_HOST_CK_USART_UDR;
+            usartISR();
+            _hostIsrEnd = t + MLED_HOST_CK_USART_ISR;
+            _hostStats.isrCycles += MLED_HOST_CK_USART_ISR;
+            cpu += MLED_HOST_CK_USART_ISR;          // такты прерывания отняты у основного цикла
+        }
+        if (!(UCSR0B & _BV(UDRIE0)) && cpu >= _hostWire) UCSR0A |= _BV(TXC0);
+        _hostStats.end = _hostWire;
+        hostCycles = cpu;
+    }
+
+public:
+    // хост: статистика последнего кадра MLED_USART_SPI (недогрузка, загрузка процессора)
+    const HostUsartStats &hostUsartStats() { return _hostStats; }
 private:
+#endif
+#endif
+
+    // буфер, который выводит show()
+    const mData *outBuf() {
+#ifdef MLED_DOUBLE_BUFFER
+        return front;
+#else
+        return leds;
+#endif
+    }
+
+#ifdef MLED_DOUBLE_BUFFER
+    // поменять буферы местами без ожидания вывода
+    void swapBuffers() {
+        mData *t = leds;
+        leds = front;
+        front = t;
+#ifdef MLED_CURRENT_TRACK
+        uint32_t s = _chSum;
+        _chSum = _chSumFront;
+        _chSumFront = s;
+#endif
+    }
+#endif
+
+    // запись диода с учётом суммы каналов (MLED_CURRENT_TRACK)
+    void put(int n, mData color) {
+#ifdef MLED_CURRENT_TRACK
+        _chSum += chSum(color) - chSum(leds[n]);
+#endif
+        leds[n] = color;
+    }
+
+    // добавить (add) или вычесть сумму каналов диодов from..to
+    void trackRange(int from, int to, bool add) {
+#ifdef MLED_CURRENT_TRACK
+        uint32_t sum = 0;
+        for (int i = from; i <= to; i++) sum += chSum(leds[i]);
+        if (add) _chSum += sum;
+        else _chSum -= sum;
+#endif
+    }
+
+    static uint16_t chSum(mData c) {
+        return getR(c) + getG(c) + getB(c);
+    }
+
+    uint8_t mWidth() { return mW ? mW : _width; }
+    uint8_t mHeight() { return mW ? mH : _height; }
+    uint8_t mConfig() { return mW ? _cfgT : _matrixConfig; }
+
+    // "линия" - ряд цепочки в координатах матрицы: строка y, если ряды идут вдоль x,
+    // иначе столбец x. Линия лежит в leds[] подряд (в зигзаге через одну - задом наперёд)
+    bool linesAlongX() {
+        return !((mConfig() >> 2) & 1);     // направление DIR_RIGHT или DIR_LEFT
+    }
+
+    // номер диода в позиции pos линии q
+    int linePix(int q, int pos) {
+        return linesAlongX() ? getPixNumber(pos, q) : getPixNumber(q, pos);
+    }
+
+    // шаг по leds[] при движении вдоль линии q: 1 или -1
+    int8_t lineStep(int q) {
+        if ((linesAlongX() ? mWidth() : mHeight()) < 2) return 1;
+        return linePix(q, 1) - linePix(q, 0);
+    }
+
+    // обрезать отрезок pos..pos+len-1 по 0..size-1. false - ничего не осталось
+    bool clip(int &pos, int &len, int size) {
+        if (pos < 0) {
+            len += pos;
+            pos = 0;
+        }
+        if (pos + len > size) len = size - pos;
+        return len > 0;
+    }
+
+    // залить len диодов линии q начиная с pos (без проверки границ)
+    void lineFill(int q, int pos, int len, mData color) {
+        int a = linePix(q, pos);
+        int b = linePix(q, pos + len - 1);
+        if (a > b) {
+            int t = a;
+            a = b;
+            b = t;
+        }
+        for (int i = a; i <= b; i++) put(i, color);
+        markDirty(b);
+    }
+
+    // сдвиг линии q длиной len на d позиций
+    void lineShift(int q, int d, int len, mData color) {
+        int lo = linePix(q, 0);
+        int8_t step = lineStep(q);
+        if (step < 0) lo -= len - 1;
+        int e = d * step;                   // сдвиг в leds[]
+        if (e >= len || e <= -len) e = 0;   // уехало целиком - просто заливка
+        else if (e > 0) memmove(&leds[lo + e], &leds[lo], (len - e) * sizeof(mData));
+        else memmove(&leds[lo], &leds[lo - e], (len + e) * sizeof(mData));
+        int from = (e > 0) ? lo : ((e < 0) ? lo + len + e : lo);
+        int cnt = e ? ((e > 0) ? e : -e) : len;
+        for (int i = 0; i < cnt; i++) leds[from + i] = color;
+    }
+
+    // линию src (0..lines-1) скопировать в линию dst, за пределами - залить color
+    void lineCopy(int dst, int src, int lines, int len, mData color) {
+        int a = linePix(dst, 0);
+        int8_t sa = lineStep(dst);
+        if (sa < 0) a -= len - 1;
+        if (src < 0 || src >= lines) {
+            for (int i = 0; i < len; i++) leds[a + i] = color;
+            return;
+        }
+        int b = linePix(src, 0);
+        int8_t sb = lineStep(src);
+        if (sb < 0) b -= len - 1;
+        if (sa == sb) memcpy(&leds[a], &leds[b], len * sizeof(mData));
+        else for (int i = 0; i < len; i++) leds[a + i] = leds[b + len - 1 - i];     // соседний ряд зигзага
+    }
+
     uint8_t _bright = 50, _showBright = 50;
+#ifdef MLED_PARTIAL_SHOW
+    int _dirty = amount;                // отправить диоды 0.._dirty-1 (первый show - всю ленту)
+    int _lastBright = -1;               // яркость прошлого show
+#endif
+#ifdef MLED_CURRENT_TRACK
+    uint32_t _chSum = 0;                // сумма R+G+B всех диодов
+#endif
+#ifdef MLED_USART_SPI
+    const mData *_uPtr;                 // следующий диод для кольца
+    const mData *_uEnd;                 // конец нарисованной части (конвейер)
+    const byte *_uWhite;
+    int _uLeft = 0;                     // диодов ещё не в кольце
+    uint16_t _uLatch = 0;               // нулевых байт паузы ресета ещё не в кольце
+    uint8_t _uRing[MLED_USART_RING];    // готовые байты SPI
+    volatile uint8_t _uHead = 0;        // сюда пишет основной цикл
+    volatile uint8_t _uTail = 0;        // отсюда берёт прерывание
+    volatile bool _uStall = false;      // прерывание остановилось на пустом кольце
+#ifdef MYARDUINO_HOST
+    uint64_t _hostWire = 0;             // такт, когда сдвиговый регистр освободится
+    uint64_t _hostFire = 0;             // такт, когда UDR0 пуст (UDRE)
+    uint64_t _hostEnable = 0;           // такт последнего разрешения UDRIE0
+    uint64_t _hostIsrEnd = 0;           // такт конца последнего прерывания
+    HostUsartStats _hostStats;
+#endif
+#endif
+#ifdef MLED_DOUBLE_BUFFER
+    mData _buf[2][amount];
+#ifdef MLED_CURRENT_TRACK
+    uint32_t _chSumFront = 0;
+#endif
+#if defined(RAMEND) && defined(RAMSTART)
+    static_assert(mledSramCheck<2UL * amount * sizeof(mData), (2UL * amount * sizeof(mData) < RAMEND - RAMSTART + 1)>::ok,
+                  "microLED: MLED_DOUBLE_BUFFER does not fit in SRAM, use COLOR_DEBTH 2 or 1");
+#endif
+#endif
     const uint8_t _matrixConfig;
 	const uint8_t _matrixType;
 	uint8_t _width;
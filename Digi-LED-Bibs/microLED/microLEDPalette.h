@@ -0,0 +1,122 @@
+/*
+    microLEDPalette - лента/матрица с палитрой: в буфере хранятся не цвета, а номера цветов палитры
+    - bits = 4: палитра 16 цветов, 2 диода в байте (300 диодов - 150 байт)
+    - bits = 8: палитра 256 цветов, 1 диод в байте
+    - цвет берётся из палитры прямо при отправке (вывод потоком microLED: begin/sendPixels/end)
+    - смена цвета палитры меняет все диоды этого цвета, rotatePalette() анимирует весь кадр
+*/
+#ifndef _microLEDPalette_h
+#define _microLEDPalette_h
+
+#include "microLED.h"
+
+#ifdef MYARDUINO_HOST
+// хост: такты на диод сверх sendPixels - LD номера, тетрада, адрес в палитре (оценка)
+#ifndef MLED_HOST_CK_PALETTE
+#define MLED_HOST_CK_PALETTE 10
+#endif
+#endif
+
+// ============================================== КЛАСС ==============================================
+// // ЛЕНТА: нет аргументов
+// microLEDPalette;
+//
+// // МАТРИЦА: как у microLED
+// microLEDPalette(uint8_t width, uint8_t height, M_type type, M_connection conn, M_dir dir);
+//
+// mData palette[16 / 256];                         // палитра
+// void set(int n, uint8_t index);                  // поставить диоду цвет палитры index
+// uint8_t get(int n);                              // номер цвета диода
+// void set(int x, int y, uint8_t index);           // то же для матрицы
+// uint8_t get(int x, int y);
+// void fill(uint8_t index);                        // залить цветом палитры
+// void fill(int from, int to, uint8_t index);      // залить диоды from..to
+// void clear();                                    // залить цветом palette[0]
+// void rotatePalette(uint8_t from, uint8_t to);    // сдвинуть цвета палитры from..to на 1 (from < to)
+// void show();                                     // вывести
+// setBrightness, setCLI, getPixNumber, begin, send, end - как у microLED
+//
+// <amount, bits, pin, clock pin, chip, order, cli, mls>
+template<int amount, uint8_t bits, int8_t pin, int8_t pinCLK, M_chip chip, M_order order, M_ISR def_isr = CLI_OFF, uint8_t uptime = 0>
+class microLEDPalette : private microLED<0, pin, pinCLK, chip, order, def_isr, uptime>
+{
+    typedef microLED<0, pin, pinCLK, chip, order, def_isr, uptime> strip;
+    static_assert(bits == 4 || bits == 8, "microLEDPalette: bits = 4 or 8");
+
+public:
+    static const int paletteSize = 1 << bits;
+    mData palette[paletteSize];
+    uint8_t idx[(amount * bits + 7) / 8];       // номера цветов, при bits = 4 чётный диод в старшей тетраде
+
+    microLEDPalette() : strip() {}
+
+    microLEDPalette(uint8_t width, uint8_t height, M_type type, M_connection conn, M_dir dir) :
+        strip(width, height, type, conn, dir) {}
+
+    using strip::setBrightness;
+    using strip::setCLI;
+    using strip::getPixNumber;
+    using strip::begin;
+    using strip::send;
+    using strip::end;
+
+    void set(int n, uint8_t index) {
+        if (bits == 8) idx[n] = index;
+        else {
+            uint8_t &b = idx[n >> 1];
+            if (n & 1) b = (b & 0xF0) | (index & 0x0F);
+            else b = (b & 0x0F) | (index << 4);
+        }
+    }
+
+    uint8_t get(int n) {
+        if (bits == 8) return idx[n];
+        return (n & 1) ? (idx[n >> 1] & 0x0F) : (idx[n >> 1] >> 4);
+    }
+
+    void set(int x, int y, uint8_t index) {
+        if (x < 0 || y < 0 || x >= this->mWidth() || y >= this->mHeight()) return;
+        set(getPixNumber(x, y), index);
+    }
+
+    uint8_t get(int x, int y) {
+        return get(getPixNumber(x, y));
+    }
+
+    void fill(uint8_t index) {
+        memset(idx, (bits == 8) ? index : (index & 0x0F) * 0x11, sizeof(idx));
+    }
+
+    void fill(int from, int to, uint8_t index) {
+        if (from < 0) from = 0;
+        if (to >= amount) to = amount - 1;
+        for (int i = from; i <= to; i++) set(i, index);
+    }
+
+    void clear() {
+        fill(0);
+    }
+
+    // сдвинуть цвета палитры from..to на одну позицию вниз (from уходит в to), при from >= to ничего
+    void rotatePalette(uint8_t from = 0, uint8_t to = paletteSize - 1) {
+        if (to >= paletteSize) to = paletteSize - 1;
+        if (from >= to) return;
+        mData first = palette[from];
+        for (uint8_t i = from; i < to; i++) palette[i] = palette[i + 1];
+        palette[to] = first;
+    }
+
+    // цвет диода берётся из палитры во время вывода предыдущего (sendPixels)
+    void show() {
+        begin();
+        this->sendPixels([this](int i, byte &) {
+#ifdef MYARDUINO_HOST
+            hostTick(MLED_HOST_CK_PALETTE);
+#endif
+            return palette[get(i)];
+        }, amount);
+        end();
+    }
+};
+
+#endif
@@ -0,0 +1,269 @@
+/*
+    microLEDParallel - до 8 лент WS281x/WS6812 на пинах одного порта, вывод одновременно
+    - линии: пины pin, pin+1 ... pin+lanes-1, все на одном порту (например 2..7 = PD2..PD7)
+    - буфер общий: leds[0..amount-1] - линия 0, leds[amount..2*amount-1] - линия 1 и т.д.
+      Цепочку ленты/матрицы режем на куски по amount - нумерация и функции рисования как у microLED
+    - один бит ленты = три записи в порт (ST X): все линии HIGH, линии с нулём LOW, все LOW.
+      Время кадра как у одной линии из amount диодов, т.е. в lanes раз меньше
+    - байт цвета всех линий транспонируется в 8 байт-слотов (бит порта = линия). Первый байт кадра -
+      transpose8, дальше asm бита сам транспонирует следующий байт в паузах текущего (LSL/ROL
+      вместо NOP). Байт через один грузится по линии: после каждого бита в LOW одна линия (~25 тактов),
+      так пауза не растёт с числом линий. Восьмая линия грузится после бита 0 вместе с нулевой
+    - только 16 и 32 МГц: при 8 МГц всё транспонирование в LOW и уже одна линия дольше 5 мкс
+    - при 16 МГц не больше 7 линий (MLED_PAR_MAX_LANES). Модель хоста (tests/test_parallel): 7 линий -
+      LOW до 4.2 мкс (WS6812 4.3), держится до MLED_HOST_CK_PAR_LANE 50; 8 линий - 4.75 мкс, и уже
+      при 27 тактах на линию больше 5 мкс (tllMax WS2812). 25 тактов - оценка без листинга avr-gcc,
+      на железе не проверено. 32 МГц: 8 линий, LOW до 2.5 мкс
+*/
+#ifndef _microLEDParallel_h
+#define _microLEDParallel_h
+
+#include "microLED.h"
+
+// Тайминг в тактах: A - от HIGH до записи слота (T0H = A + 2), B - до LOW (T1H = A + B + 4),
+// L - от LOW до записи готового слота (TL = L + 10). F - для WS2811/WS6812.
+// В A, B и L стоят 8 пар LSL/ROL транспонирования следующего байта (MLED_PAR_P(n) - линия n).
+// TL между битами больше на загрузку линии (см. MLED_HOST_CK_PAR_*)
+#define MLED_PAR_NOP1 "NOP                   \n\t"
+#define MLED_PAR_NOP2 "RJMP .+0              \n\t"
+#define MLED_PAR_NOP4 MLED_PAR_NOP2 MLED_PAR_NOP2
+#define MLED_PAR_P(n) "LSL %[A" #n "]             \n\t" "ROL %[R]              \n\t"
+#if (F_CPU == 32000000UL)
+#define MLED_PAR_A  MLED_PAR_P(7) MLED_PAR_P(6) MLED_PAR_P(5) MLED_PAR_P(4) MLED_PAR_P(3)   // 375 / 750 / 312 нс
+#define MLED_PAR_B  MLED_PAR_P(2) MLED_PAR_P(1) MLED_PAR_P(0) MLED_PAR_NOP4
+#define MLED_PAR_L  ""
+#define MLED_PAR_FA MLED_PAR_P(7) MLED_PAR_P(6) MLED_PAR_P(5)                               // 250 / 625 / 500 нс
+#define MLED_PAR_FB MLED_PAR_P(4) MLED_PAR_P(3) MLED_PAR_P(2) MLED_PAR_P(1) MLED_PAR_P(0)
+#define MLED_PAR_FL MLED_PAR_NOP4 MLED_PAR_NOP2
+#define MLED_PAR_CK 10, 10, 0, 6, 10, 6
+#elif (F_CPU == 16000000UL)
+#define MLED_PAR_A  MLED_PAR_P(7) MLED_PAR_P(6)                                             // 375 / 750 / 1125 нс
+#define MLED_PAR_B  MLED_PAR_P(5) MLED_PAR_P(4)
+#define MLED_PAR_L  MLED_PAR_P(3) MLED_PAR_P(2) MLED_PAR_P(1) MLED_PAR_P(0)
+#define MLED_PAR_FA MLED_PAR_P(7)                                                           // 250 / 625 / 1250 нс
+#define MLED_PAR_FB MLED_PAR_P(6) MLED_PAR_P(5)
+#define MLED_PAR_FL MLED_PAR_P(4) MLED_PAR_P(3) MLED_PAR_P(2) MLED_PAR_P(1) MLED_PAR_P(0)
+#define MLED_PAR_CK 4, 4, 8, 2, 4, 10
+#ifndef MLED_PAR_MAX_LANES
+#define MLED_PAR_MAX_LANES 7        // 8-я линия - две загрузки в одном LOW, запас 1-2 такта (см. выше)
+#endif
+#else
+// 8 МГц: места в HIGH нет, 8 пар LSL/ROL + загрузка линии в LOW - больше 5 мкс уже на одной линии
+#error "microLEDParallel: F_CPU 16 or 32 MHz only"
+#endif
+#ifndef MLED_PAR_MAX_LANES
+#define MLED_PAR_MAX_LANES 8
+#endif
+
+#ifdef MYARDUINO_HOST
+// хост: такты C-кода между asm битами (оценка по инструкциям avr-gcc -Os, можно задать через -D)
+// MLED_HOST_CK_PAR_BYTE - цикл show() на байт: курсор, обмен буферов, проверки isr
+// MLED_HOST_CK_PAR_BIT  - цикл по битам в sendSlots (вместо DEC/BRNE в asm)
+// MLED_HOST_CK_PAR_LANE - одна линия: _laneBit, адрес диода, выбор канала, fade8 (MUL), ST в буфер
+#ifndef MLED_HOST_CK_PAR_BYTE
+#define MLED_HOST_CK_PAR_BYTE 24
+#endif
+#ifndef MLED_HOST_CK_PAR_BIT
+#define MLED_HOST_CK_PAR_BIT 5
+#endif
+#ifndef MLED_HOST_CK_PAR_LANE
+#define MLED_HOST_CK_PAR_LANE 25
+#endif
+#endif
+
+// ============================================== КЛАСС ==============================================
+// // ЛЕНТА: нет аргументов, МАТРИЦА: как у microLED (размер всей матрицы)
+// microLEDParallel;
+// microLEDParallel(uint8_t width, uint8_t height, M_type type, M_connection conn, M_dir dir);
+//
+// всё рисование, яркость, ток и поток (begin/send/end - только линия 0) как у microLED
+// void show();                                     // вывести все линии одновременно
+//
+// <amount на линию, lanes, первый пин, chip, order, cli, mls, [матрица]>
+template<int amount, uint8_t lanes, int8_t pin, M_chip chip, M_order order, M_ISR def_isr = CLI_OFF, uint8_t uptime = 0,
+         uint8_t mW = 0, uint8_t mH = 0, M_type mType = ZIGZAG, M_connection mConn = LEFT_BOTTOM, M_dir mDir = DIR_RIGHT>
+class microLEDParallel : public microLED<amount * lanes, pin, MLED_NO_CLOCK, chip, order, def_isr, uptime, mW, mH, mType, mConn, mDir>
+{
+    typedef microLED<amount * lanes, pin, MLED_NO_CLOCK, chip, order, def_isr, uptime, mW, mH, mType, mConn, mDir> strip;
+    static_assert(lanes >= 1 && lanes <= MLED_PAR_MAX_LANES, "microLEDParallel: lanes = 1..8, at 16 MHz 1..7 (MLED_PAR_MAX_LANES)");
+    static_assert(chip != LED_APA102 && chip != LED_APA102_SPI, "microLEDParallel: WS281x/WS6812 only");
+
+public:
+    microLEDParallel() : strip() {
+        initLanes();
+    }
+
+    microLEDParallel(uint8_t width, uint8_t height, M_type type, M_connection conn, M_dir dir) :
+        strip(width, height, type, conn, dir) {
+        initLanes();
+    }
+
+    void show() {
+        strip::begin();
+        this->_mask_h = *this->_dat_port | _lanesMask;  // снимок порта, как в begin(), но для всех линий
+        this->_mask_l = *this->_dat_port & ~_lanesMask;
+        if (this->_maxCurrent != 0) this->_showBright = this->correctBright(this->_bright);
+        const uint8_t bpl = (CHIP4COLOR) ? 4 : 3;
+        uint8_t buf[2][8];              // байты всех линий по битам порта, без линии - 0
+        uint8_t *next = buf[0];         // следующий байт: его транспонирует отправка текущего
+        uint8_t *load = buf[1];         // байт через один: отправка текущего грузит его по линии на бит
+        uint8_t slots[8];               // слоты текущего байта, отправка пишет сюда следующий
+        int li = 0;                     // диод и канал байта для load
+        uint8_t lc = 0;
+        memset(buf, 0, sizeof(buf));
+        if (amount) {
+            loadByte(next, 0, 0);
+            transpose8(next, slots);
+            if (++lc == bpl) lc = 0, li++;
+            if (li < amount) loadByte(next, li, lc);
+            if (++lc == bpl) lc = 0, li++;
+        }
+        for (int i = 0; i < amount; i++) {
+            if (this->isr == CLI_AVER) {    // диод целиком
+                this->sregSave = SREG;
+                cli();
+            }
+            for (uint8_t c = 0; c < bpl; c++) {
+#ifdef MYARDUINO_HOST
+                hostTick(MLED_HOST_CK_PAR_BYTE);
+#endif
+                if (this->isr == CLI_LOW) {
+                    this->sregSave = SREG;
+                    cli();
+                }
+                sendSlots(slots, next, load, li, lc);
+                if (this->isr == CLI_LOW) SREG = this->sregSave;
+                uint8_t *t = next;
+                next = load;
+                load = t;
+                if (++lc == bpl) lc = 0, li++;
+            }
+            if (this->isr == CLI_AVER) SREG = this->sregSave;
+            if (uptime && (this->isr == CLI_AVER || this->isr == CLI_HIGH)) systemUptimePoll();  // пнуть миллисы
+        }
+        strip::end();
+    }
+
+private:
+    // пины линий: только на порту первого пина, остальные пропускаются
+    void initLanes() {
+        _lanesMask = 0;
+        uint8_t port = digitalPinToPort(pin);
+        for (uint8_t l = 0; l < lanes; l++) {
+            _laneBit[l] = 0xFF;
+            if (digitalPinToPort(pin + l) != port) continue;
+            uint8_t mask = digitalPinToBitMask(pin + l);
+            _lanesMask |= mask;
+            for (uint8_t b = 0; b < 8; b++) if (mask == (1 << b)) _laneBit[l] = b;
+        }
+        *this->_dat_ddr |= _lanesMask;
+    }
+
+    // байт c (в порядке ленты, с яркостью) диода i линии l -> in[бит порта линии]
+    inline __attribute__((always_inline)) void loadLane(uint8_t *in, uint8_t l, int i, uint8_t c) {
+#ifdef MYARDUINO_HOST
+        hostTick(MLED_HOST_CK_PAR_LANE + MLED_HOST_CK_UNPACK / 3);
+#endif
+        uint8_t b = _laneBit[l];
+        if (b > 7) return;
+        const mData *out = this->outBuf();
+        int k = l * amount + i;
+        if (c == ((order >> 4) & 0b11)) in[b] = fade8R(out[k], this->_showBright);
+        else if (c == ((order >> 2) & 0b11)) in[b] = fade8G(out[k], this->_showBright);
+        else if (c == (order & 0b11)) in[b] = fade8B(out[k], this->_showBright);
+        else if (CHIP4COLOR) in[b] = fade8(this->white[k], this->_showBright);
+        else in[b] = 0;                 // у 3-цветных white[] пустой
+    }
+
+    // байт c диода i всех линий, только до начала кадра
+    void loadByte(uint8_t *in, int i, uint8_t c) {
+        for (uint8_t l = 0; l < lanes; l++) loadLane(in, l, i, c);
+    }
+
+    // после бита bit в LOW: линия bit байта через один. Бит 7 без загрузки - за ним ещё переход
+    // к следующему байту, линия 7 грузится после бита 0 вместе с линией 0
+    inline __attribute__((always_inline)) void loadAfterBit(uint8_t bit, uint8_t *load, int li, uint8_t lc) {
+        if (li >= amount) return;
+        if (bit < 7 && bit < lanes) loadLane(load, bit, li, lc);
+        if (bit == 0 && lanes == 8) loadLane(load, 7, li, lc);
+    }
+
+    // отправить 8 слотов: HIGH на всех линиях, слот (линии с нулём уходят в LOW), LOW.
+    // В паузах каждого бита один выходной байт transpose8(next) ложится на место отправленного слота,
+    // после бита в LOW грузится одна линия байта (li, lc) в load. asm - один бит, цикл по битам в C
+    inline __attribute__((always_inline)) void sendSlots(uint8_t *slots, const uint8_t *next, uint8_t *load, int li, uint8_t lc) {
+        const bool fast = (chip == LED_WS2811 || chip == LED_WS6812);
+#ifdef MYARDUINO_HOST
+        const uint8_t ck[6] = { MLED_PAR_CK };
+        const uint8_t *t = fast ? ck + 3 : ck;
+        hostTick(8 * 2 + 1);                                // загрузка next в регистры, счётчик
+        for (uint8_t i = 0; i < 8; i++) {
+            hostTick(2 + 1 + 2);                            // LD, OR, ST HIGH
+            hostPortWrite(this->_dat_port, this->_mask_h);
+            hostTick(t[0] + 2);                             // A, ST слот
+            hostPortWrite(this->_dat_port, slots[i] | this->_mask_l);
+            hostTick(t[1] + 2);                             // B, ST LOW
+            hostPortWrite(this->_dat_port, this->_mask_l);
+            hostTick(t[2] + 2 + MLED_HOST_CK_PAR_BIT);      // L, ST Z+, цикл
+            loadAfterBit(i, load, li, lc);
+        }
+        transpose8(next, slots);
+#else
+        uint8_t a0 = next[0], a1 = next[1], a2 = next[2], a3 = next[3];
+        uint8_t a4 = next[4], a5 = next[5], a6 = next[6], a7 = next[7];
+        uint8_t data, r;
+        uint8_t *z = slots;
+        for (uint8_t i = 0; i < 8; i++) {
+            if (fast) {
+                asm volatile
+                (
+                "LD %[DATA], Z         \n\t"  // 2CK слот
+                "OR %[DATA], %[SET_L]  \n\t"  // 1CK остальные биты порта
+                "ST X, %[SET_H]        \n\t"  // 2CK все линии HIGH
+                MLED_PAR_FA
+                "ST X, %[DATA]         \n\t"  // 2CK линии с нулём - LOW
+                MLED_PAR_FB
+                "ST X, %[SET_L]        \n\t"  // 2CK все линии LOW
+                MLED_PAR_FL
+                "ST Z+, %[R]           \n\t"  // 2CK слот следующего байта
+                :[DATA] "=&r" (data), [R] "=&r" (r),
+                [A0] "+r" (a0), [A1] "+r" (a1), [A2] "+r" (a2), [A3] "+r" (a3),
+                [A4] "+r" (a4), [A5] "+r" (a5), [A6] "+r" (a6), [A7] "+r" (a7),
+                "+z" (z)
+                :[SET_H] "r" (this->_mask_h),
+                [SET_L] "r" (this->_mask_l),
+                "x" (this->_dat_port)
+                :"memory"
+                );
+            } else {
+                asm volatile
+                (
+                "LD %[DATA], Z         \n\t"  // 2CK слот
+                "OR %[DATA], %[SET_L]  \n\t"  // 1CK остальные биты порта
+                "ST X, %[SET_H]        \n\t"  // 2CK все линии HIGH
+                MLED_PAR_A
+                "ST X, %[DATA]         \n\t"  // 2CK линии с нулём - LOW
+                MLED_PAR_B
+                "ST X, %[SET_L]        \n\t"  // 2CK все линии LOW
+                MLED_PAR_L
+                "ST Z+, %[R]           \n\t"  // 2CK слот следующего байта
+                :[DATA] "=&r" (data), [R] "=&r" (r),
+                [A0] "+r" (a0), [A1] "+r" (a1), [A2] "+r" (a2), [A3] "+r" (a3),
+                [A4] "+r" (a4), [A5] "+r" (a5), [A6] "+r" (a6), [A7] "+r" (a7),
+                "+z" (z)
+                :[SET_H] "r" (this->_mask_h),
+                [SET_L] "r" (this->_mask_l),
+                "x" (this->_dat_port)
+                :"memory"
+                );
+            }
+            loadAfterBit(i, load, li, lc);
+        }
+#endif
+    }
+
+    uint8_t _laneBit[lanes];            // бит порта линии, 0xFF - пин не на этом порту
+    uint8_t _lanesMask;
+};
+
+#endif
@@ -2,8 +2,16 @@
 #ifndef MyArduino_h
 #define MyArduino_h
 
+#if defined(__AVR__)
 #include <avr/io.h>
 #include <avr/pgmspace.h>
+typedef uint16_t port_addr_t;	// Registeradresse in den PGM-Tabellen
+#define pgm_read_port(addr) pgm_read_word(addr)
+#else
+#include "myarduino_host.h"		// Host-Build: simulierte Register
+typedef uintptr_t port_addr_t;
+#define pgm_read_port(addr) (*(addr))
+#endif
 
 typedef unsigned int word;
 typedef uint8_t byte;
@@ -52,28 +60,28 @@ typedef uint8_t byte;
 //extern const uint8_t PROGMEM digital_pin_to_bit_mask_PGM[];
 //extern const uint8_t PROGMEM digital_pin_to_timer_PGM[];
 
-const uint16_t PROGMEM port_to_mode_PGM[] = {
+const port_addr_t PROGMEM port_to_mode_PGM[] = {
 	NOT_A_PORT,
 	NOT_A_PORT,
-	(uint16_t) &DDRB,
-	(uint16_t) &DDRC,
-	(uint16_t) &DDRD,
+	(port_addr_t) &DDRB,
+	(port_addr_t) &DDRC,
+	(port_addr_t) &DDRD,
 };
 
-const uint16_t PROGMEM port_to_input_PGM[] = {
+const port_addr_t PROGMEM port_to_input_PGM[] = {
 	NOT_A_PORT,
 	NOT_A_PORT,
-	(uint16_t) &PINB,
-	(uint16_t) &PINC,
-	(uint16_t) &PIND,
+	(port_addr_t) &PINB,
+	(port_addr_t) &PINC,
+	(port_addr_t) &PIND,
 };
 
-const uint16_t PROGMEM port_to_output_PGM[] = {
+const port_addr_t PROGMEM port_to_output_PGM[] = {
 	NOT_A_PORT,
 	NOT_A_PORT,
-	(uint16_t) &PORTB,
-	(uint16_t) &PORTC,
-	(uint16_t) &PORTD,
+	(port_addr_t) &PORTB,
+	(port_addr_t) &PORTC,
+	(port_addr_t) &PORTD,
 };
 
 
@@ -169,8 +177,8 @@ const uint8_t PROGMEM digital_pin_to_timer_PGM[] = {
 #define digitalPinToBitMask(P) ( pgm_read_byte(digital_pin_to_bit_mask_PGM + (P)) )
 #define digitalPinToTimer(P) ( pgm_read_byte(digital_pin_to_timer_PGM + (P)) )
 
-#define portOutputRegister(P) ( (volatile uint8_t *)( pgm_read_word(port_to_output_PGM + (P))) )
-#define portInputRegister(P) ( (volatile uint8_t *)( pgm_read_word(port_to_input_PGM + (P))) )
-#define portModeRegister(P) ( (volatile uint8_t *)( pgm_read_word(port_to_mode_PGM + (P))) )
+#define portOutputRegister(P) ( (volatile uint8_t *)( pgm_read_port(port_to_output_PGM + (P))) )
+#define portInputRegister(P) ( (volatile uint8_t *)( pgm_read_port(port_to_input_PGM + (P))) )
+#define portModeRegister(P) ( (volatile uint8_t *)( pgm_read_port(port_to_mode_PGM + (P))) )
 
 #endif
\ No newline at end of file
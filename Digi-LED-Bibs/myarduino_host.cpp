@@ -0,0 +1,437 @@
+/*
+ * myarduino_host.cpp
+ * Register und Portaufzeichnung für den Host-Build (siehe myarduino_host.h).
+ *
+ * Created: 16.10.2026 19:12:40
+ *  Author: Iggy
+ */
+#ifndef __AVR__
+
+#include "myarduino_host.h"
+#include <stdio.h>
+
+volatile uint8_t PINB, DDRB, PORTB;
+volatile uint8_t PINC, DDRC, PORTC;
+volatile uint8_t PIND, DDRD, PORTD;
+HostSREG SREG = { _BV(SREG_I) };
+volatile uint8_t UCSR0A = _BV(UDRE0), UCSR0B, UCSR0C;
+volatile uint16_t UBRR0;
+
+uint64_t hostCycles = 0;
+
+static HostPortEvent traceBuf[HOST_TRACE_SIZE];
+static uint32_t traceCount = 0;
+static uint32_t traceLost = 0;
+
+static uint64_t cliStart = 0;		// Beginn der laufenden Sperre
+static uint64_t cliSum = 0;			// abgeschlossene Sperren
+static uint64_t cliMax = 0;
+
+HostSREG &HostSREG::operator=(uint8_t v)
+{
+	bool wasOn = value & _BV(SREG_I);
+	bool isOn = v & _BV(SREG_I);
+	if (wasOn && !isOn) {
+		cliStart = hostCycles;
+	} else if (!wasOn && isOn) {
+		uint64_t len = hostCycles - cliStart;
+		cliSum += len;
+		if (len > cliMax) cliMax = len;
+	}
+	value = v;
+	return *this;
+}
+
+void _delay_ms(double ms)
+{
+	hostCycles += (uint64_t)(ms * (F_CPU / 1000UL));
+}
+
+void _delay_us(double us)
+{
+	hostCycles += (uint64_t)(us * F_CPU / 1000000UL);
+}
+
+void hostPortWrite(volatile uint8_t *port, uint8_t value)
+{
+	*port = value;
+	if (traceCount < HOST_TRACE_SIZE) {
+		traceBuf[traceCount].cycle = hostCycles;
+		traceBuf[traceCount].port = port;
+		traceBuf[traceCount].value = value;
+		traceCount++;
+	} else {
+		traceLost++;
+	}
+}
+
+void hostUsartSpiWrite(uint8_t data)
+{
+	for (uint8_t i = 0; i < 8; i++) {
+		hostPortWrite(&PORTD, (data & 0x80) ? (PORTD | _BV(PORTD1)) : (PORTD & ~_BV(PORTD1)));
+		hostTick(2 * (UBRR0 + 1));
+		data <<= 1;
+	}
+}
+
+void hostTraceReset(void)
+{
+	hostCycles = 0;
+	traceCount = 0;
+	traceLost = 0;
+	cliStart = 0;
+	cliSum = 0;
+	cliMax = 0;
+}
+
+uint32_t hostTraceCount(void)
+{
+	return traceCount;
+}
+
+uint32_t hostTraceLost(void)
+{
+	return traceLost;
+}
+
+const HostPortEvent *hostTraceEvents(void)
+{
+	return traceBuf;
+}
+
+uint64_t hostCliCycles(void)
+{
+	if (SREG & _BV(SREG_I)) return cliSum;
+	return cliSum + (hostCycles - cliStart);
+}
+
+uint64_t hostCliMax(void)
+{
+	if (SREG & _BV(SREG_I)) return cliMax;
+	uint64_t len = hostCycles - cliStart;
+	return (len > cliMax) ? len : cliMax;
+}
+
+bool hostWriteStats(const char *file, const char *name, uint16_t pixels, uint32_t resetUs)
+{
+	FILE *f = fopen(file, "a");
+	if (!f) return false;
+	if (ftell(f) == 0)
+		fprintf(f, "name,pixels,cycles,cycles_per_pixel,frame_us,fps,cli_us,cli_max_us\n");
+
+	double us = (double)hostCycles * 1000000.0 / F_CPU;
+	fprintf(f, "%s,%u,%llu,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+		name, pixels, (unsigned long long)hostCycles,
+		pixels ? (double)hostCycles / pixels : 0.0,
+		us, 1000000.0 / (us + resetUs),
+		(double)hostCliCycles() * 1000000.0 / F_CPU,
+		(double)hostCliMax() * 1000000.0 / F_CPU);
+	fclose(f);
+	return true;
+}
+
+//									T0H			T1H			TL/TLL		Reset
+const HostBitTiming hostTimingWS2811 = { 100,  400,  450,  750,  500, 5000,  50000 };
+const HostBitTiming hostTimingWS2812 = { 250,  550,  650,  950,  300, 5000,  50000 };
+const HostBitTiming hostTimingWS2813 = { 220,  380,  580, 1600,  220, 5000, 280000 };
+const HostBitTiming hostTimingWS2815 = { 220,  380,  580, 1600,  220, 5000, 280000 };
+const HostBitTiming hostTimingWS2818 = { 220,  380,  580, 1000,  220, 5000, 280000 };
+const HostBitTiming hostTimingSK6812 = { 150,  450,  450,  750,  450, 5000,  80000 };
+
+static void minmax(uint32_t v, uint32_t *mn, uint32_t *mx)
+{
+	if (v < *mn) *mn = v;
+	if (v > *mx) *mx = v;
+}
+
+uint32_t hostCheckTiming(volatile uint8_t *port, uint8_t mask,
+						 const HostBitTiming *t, HostTimingReport *rep)
+{
+	memset(rep, 0, sizeof(*rep));
+	rep->t0hMin = rep->t1hMin = rep->tlMin = UINT32_MAX;
+
+	uint32_t split = (t->t0hMax + t->t1hMin) / 2;	// Schwelle 0/1 in ns
+	bool level = false;
+	bool inFrame = false;
+	uint64_t rise = 0, fall = 0;
+
+	for (uint32_t i = 0; i < traceCount; i++) {
+		const HostPortEvent *e = &traceBuf[i];
+		if (e->port != port) continue;
+		bool now = (e->value & mask) != 0;
+		if (now == level) continue;		// kein Flankenwechsel
+		level = now;
+
+		if (now) {						// steigende Flanke
+			if (inFrame) {
+				uint64_t low = hostCyclesToNs(e->cycle - fall);
+				if (low >= t->resetMin) {
+					rep->latches++;
+				} else {
+					minmax(e->cycle - fall, &rep->tlMin, &rep->tlMax);
+					if (low < t->tlMin || low > t->tllMax) {
+						if (!rep->errors) rep->firstError = rep->bits - 1;
+						rep->errors++;
+					}
+				}
+			}
+			rise = e->cycle;
+			inFrame = true;
+		} else {						// fallende Flanke: ein Bit fertig
+			uint64_t high = hostCyclesToNs(e->cycle - rise);
+			bool one = high >= split;
+			bool ok;
+			if (one) {
+				minmax(e->cycle - rise, &rep->t1hMin, &rep->t1hMax);
+				ok = (high >= t->t1hMin && high <= t->t1hMax);
+			} else {
+				minmax(e->cycle - rise, &rep->t0hMin, &rep->t0hMax);
+				ok = (high >= t->t0hMin && high <= t->t0hMax);
+			}
+			if (!ok) {
+				if (!rep->errors) rep->firstError = rep->bits;
+				rep->errors++;
+			}
+			rep->bits++;
+			fall = e->cycle;
+		}
+	}
+	if (rep->t0hMin == UINT32_MAX) rep->t0hMin = 0;
+	if (rep->t1hMin == UINT32_MAX) rep->t1hMin = 0;
+	if (rep->tlMin == UINT32_MAX) rep->tlMin = 0;
+	return rep->errors;
+}
+
+// ======================== Frame-Dekoder ========================
+// Stelle von R, G, B, W im Datenstrom einer LED
+static void orderPos(uint8_t order, uint8_t bpp, uint8_t pos[4])
+{
+	pos[0] = (order >> 4) & 3;
+	pos[1] = (order >> 2) & 3;
+	pos[2] = order & 3;
+	pos[3] = (order >> 6) & 3;
+	if (pos[3] == pos[0] || pos[3] == pos[1] || pos[3] == pos[2]) pos[3] = 3;
+	if (bpp < 4) pos[3] = 0xFF;
+}
+
+int32_t hostDecodeFrame(volatile uint8_t *port, uint8_t mask, const HostBitTiming *t,
+						uint8_t order, uint8_t bpp, uint32_t frame, HostPixel *pix, uint32_t maxPix)
+{
+	uint8_t pos[4];
+	orderPos(order, bpp, pos);
+	uint32_t split = (t->t0hMax + t->t1hMin) / 2;
+	bool level = false;
+	bool inFrame = false;
+	uint32_t cur = 0;				// Nummer des laufenden Frames
+	uint64_t rise = 0, fall = 0;
+	uint8_t data[4];
+	uint8_t byte = 0, bit = 0, n = 0;
+	uint32_t count = 0;
+
+	for (uint32_t i = 0; i < traceCount; i++) {
+		const HostPortEvent *e = &traceBuf[i];
+		if (e->port != port) continue;
+		bool now = (e->value & mask) != 0;
+		if (now == level) continue;
+		level = now;
+
+		if (now) {
+			if (inFrame && hostCyclesToNs(e->cycle - fall) >= t->resetMin) {
+				if (cur == frame) return count;		// Latch: Frame fertig
+				cur++;
+				byte = bit = n = 0;
+			}
+			rise = e->cycle;
+			inFrame = true;
+		} else {
+			fall = e->cycle;
+			if (cur != frame) continue;
+			byte = (byte << 1) | (hostCyclesToNs(e->cycle - rise) >= split);
+			if (++bit < 8) continue;
+			data[n++] = byte;
+			bit = 0;
+			if (n < bpp) continue;
+			n = 0;
+			if (count < maxPix) {
+				HostPixel *p = &pix[count];
+				p->r = data[pos[0]];
+				p->g = data[pos[1]];
+				p->b = data[pos[2]];
+				p->w = (pos[3] < 4) ? data[pos[3]] : 0;
+			}
+			count++;
+		}
+	}
+	return (inFrame && cur == frame) ? (int32_t)count : -1;
+}
+
+// ======================== Frame-Log ========================
+static const char logMagic[4] = { 'M', 'L', 'F', '1' };
+
+static bool logWrite(FILE *f, const HostPixel *pix, uint16_t n, uint8_t bpp)
+{
+	uint8_t head[3] = { (uint8_t)n, (uint8_t)(n >> 8), bpp };
+	if (fwrite(head, 1, 3, f) != 3) return false;
+	for (uint16_t i = 0; i < n; i++) {
+		uint8_t c[4] = { pix[i].r, pix[i].g, pix[i].b, pix[i].w };
+		if (fwrite(c, 1, bpp, f) != bpp) return false;
+	}
+	return true;
+}
+
+static FILE *logOpen(const char *file)
+{
+	FILE *f = fopen(file, "ab");
+	if (!f) return 0;
+	fseek(f, 0, SEEK_END);
+	if (ftell(f) == 0 && fwrite(logMagic, 1, 4, f) != 4) {
+		fclose(f);
+		return 0;
+	}
+	return f;
+}
+
+bool hostLogWrite(const char *file, const HostPixel *pix, uint16_t n, uint8_t bpp)
+{
+	FILE *f = logOpen(file);
+	if (!f) return false;
+	bool ok = logWrite(f, pix, n, (bpp < 4) ? 3 : 4);
+	return (fclose(f) == 0) && ok;
+}
+
+int32_t hostLogFrames(const char *file, volatile uint8_t *port, uint8_t mask,
+					  const HostBitTiming *t, uint8_t order, uint8_t bpp)
+{
+	uint32_t maxPix = traceCount / 48 + 1;	// 2 Einträge je Bit, 24 Bits je LED
+	if (maxPix > 65535) maxPix = 65535;
+	HostPixel *pix = (HostPixel *)malloc(maxPix * sizeof(HostPixel));
+	FILE *f = pix ? logOpen(file) : 0;
+	if (!f) {
+		free(pix);
+		return -1;
+	}
+	bpp = (bpp < 4) ? 3 : 4;
+	int32_t frames = 0;
+	int32_t n;
+	while ((n = hostDecodeFrame(port, mask, t, order, bpp, frames, pix, maxPix)) >= 0) {
+		if (!logWrite(f, pix, (n > (int32_t)maxPix) ? maxPix : n, bpp)) {
+			frames = -1;
+			break;
+		}
+		frames++;
+	}
+	free(pix);
+	if (fclose(f) != 0) return -1;
+	return frames;
+}
+
+// Kopf prüfen, Datei steht danach am ersten Frame
+static FILE *logOpenRead(const char *file)
+{
+	FILE *f = fopen(file, "rb");
+	if (!f) return 0;
+	char magic[4];
+	if (fread(magic, 1, 4, f) != 4 || memcmp(magic, logMagic, 4)) {
+		fclose(f);
+		return 0;
+	}
+	return f;
+}
+
+static bool logHead(FILE *f, uint16_t *n, uint8_t *bpp)
+{
+	uint8_t head[3];
+	if (fread(head, 1, 3, f) != 3) return false;
+	*n = head[0] | (head[1] << 8);
+	*bpp = head[2];
+	return true;
+}
+
+static bool logPixel(FILE *f, uint8_t bpp, HostPixel *p)
+{
+	uint8_t c[4] = { 0, 0, 0, 0 };
+	if (fread(c, 1, bpp, f) != bpp) return false;
+	p->r = c[0];
+	p->g = c[1];
+	p->b = c[2];
+	p->w = c[3];
+	return true;
+}
+
+int32_t hostLogRead(const char *file, uint32_t frame, HostPixel *pix, uint32_t maxPix, uint8_t *bpp)
+{
+	FILE *f = logOpenRead(file);
+	if (!f) return -1;
+	int32_t ret = -1;
+	uint16_t n;
+	uint8_t b;
+	for (uint32_t cur = 0; logHead(f, &n, &b); cur++) {
+		if (cur != frame) {
+			if (fseek(f, (long)n * b, SEEK_CUR) != 0) break;
+			continue;
+		}
+		uint32_t i;
+		HostPixel p;
+		for (i = 0; i < n && logPixel(f, b, &p); i++) {
+			if (i < maxPix) pix[i] = p;
+		}
+		if (i == n) {
+			ret = n;
+			if (bpp) *bpp = b;
+		}
+		break;
+	}
+	fclose(f);
+	return ret;
+}
+
+static uint8_t absDiff(uint8_t a, uint8_t b)
+{
+	return (a > b) ? a - b : b - a;
+}
+
+int32_t hostLogCompare(const char *ref, const char *test, uint8_t tol, HostLogDiff *d)
+{
+	memset(d, 0, sizeof(*d));
+	FILE *fr = logOpenRead(ref);
+	FILE *ft = logOpenRead(test);
+	int32_t ret = -1;
+	if (!fr || !ft) goto done;
+
+	for (;;) {
+		uint16_t nr, nt;
+		uint8_t br, bt;
+		bool hr = logHead(fr, &nr, &br);
+		bool ht = logHead(ft, &nt, &bt);
+		if (!hr && !ht) break;					// beide zu Ende
+		if (hr != ht || nr != nt || br != bt) goto done;	// Aufbau verschieden
+		for (uint16_t i = 0; i < nr; i++) {
+			HostPixel a, b;
+			if (!logPixel(fr, br, &a) || !logPixel(ft, bt, &b)) goto done;
+			uint8_t m = absDiff(a.r, b.r);
+			uint8_t x = absDiff(a.g, b.g);
+			if (x > m) m = x;
+			x = absDiff(a.b, b.b);
+			if (x > m) m = x;
+			x = absDiff(a.w, b.w);
+			if (x > m) m = x;
+			if (m > d->maxDiff) d->maxDiff = m;
+			if (m > tol) {
+				if (!d->pixels) {
+					d->firstFrame = d->frames;
+					d->firstPixel = i;
+				}
+				d->pixels++;
+			}
+		}
+		d->frames++;
+	}
+	ret = d->pixels;
+
+done:
+	if (fr) fclose(fr);
+	if (ft) fclose(ft);
+	return ret;
+}
+
+#endif
@@ -0,0 +1,234 @@
+/*
+ * myarduino_host.h
+ * Host-Backend für myarduino.h (Linux/PC, kein __AVR__).
+ * Ersetzt die AVR-Register durch Variablen, damit microLED und
+ * AdafruitMyPixel ohne Board übersetzt und vermessen werden können.
+ * Die Ausgaberoutinen schreiben den Daten-/Taktport über hostPortWrite(),
+ * jeder Schreibzugriff wird mit Zeitstempel (simulierte CPU-Takte)
+ * aufgezeichnet. Die Takte werden von den Ausgaberoutinen nach dem
+ * Taktmodell des jeweiligen asm-Codes mit hostTick() weitergezählt.
+ *
+ * Created: 16.10.2026 19:12:40
+ *  Author: Iggy
+ */
+#ifndef MyArduinoHost_h
+#define MyArduinoHost_h
+
+#define MYARDUINO_HOST
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+// ======================== Register ========================
+extern volatile uint8_t PINB, DDRB, PORTB;
+extern volatile uint8_t PINC, DDRC, PORTC;
+extern volatile uint8_t PIND, DDRD, PORTD;
+
+#define SREG_I 7
+
+// USART0 (для вывода microLED через USART в режиме SPI)
+extern volatile uint8_t UCSR0A, UCSR0B, UCSR0C;
+extern volatile uint16_t UBRR0;
+#define TXC0	6
+#define UDRE0	5
+#define UDRIE0	5
+#define TXEN0	3
+#define UMSEL01	7
+#define UMSEL00	6
+#define DDD1	1
+#define DDD4	4
+#define PORTD1	1
+
+// SREG zählt mit, wie lange das I-Bit gelöscht ist (Zeit ohne Interrupts)
+struct HostSREG
+{
+	uint8_t value;
+	operator uint8_t() const { return value; }
+	HostSREG &operator=(uint8_t v);
+	HostSREG &operator&=(uint8_t v) { return *this = (uint8_t)(value & v); }
+	HostSREG &operator|=(uint8_t v) { return *this = (uint8_t)(value | v); }
+};
+extern HostSREG SREG;
+
+#define PINB0 0
+#define PINB1 1
+#define PINB2 2
+#define PINB3 3
+#define PINB4 4
+#define PINB5 5
+#define PINB6 6
+#define PINB7 7
+
+#define PINC0 0
+#define PINC1 1
+#define PINC2 2
+#define PINC3 3
+#define PINC4 4
+#define PINC5 5
+#define PINC6 6
+
+#define PIND0 0
+#define PIND1 1
+#define PIND2 2
+#define PIND3 3
+#define PIND4 4
+#define PIND5 5
+#define PIND6 6
+#define PIND7 7
+
+#ifndef _BV
+#define _BV(b) (1 << (b))
+#endif
+
+// Interrupts: nur das I-Bit im SREG nachbilden
+static inline void cli(void) { SREG &= (uint8_t)~_BV(SREG_I); }
+static inline void sei(void) { SREG |= _BV(SREG_I); }
+
+// ======================== PROGMEM ========================
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+
+// ======================== Zeit ========================
+extern uint64_t hostCycles;		// simulierte CPU-Takte seit hostTraceReset()
+
+void _delay_ms(double ms);		// zählt nur hostCycles weiter
+void _delay_us(double us);
+
+// ======================== Portaufzeichnung ========================
+#ifndef HOST_TRACE_SIZE
+#define HOST_TRACE_SIZE 65536	// max. Anzahl Einträge bis zum nächsten Reset
+#endif
+
+struct HostPortEvent
+{
+	uint64_t cycle;				// Zeitpunkt in CPU-Takten
+	volatile uint8_t *port;		// beschriebenes Register
+	uint8_t value;				// geschriebener Wert
+};
+
+static inline void hostTick(uint16_t cycles) { hostCycles += cycles; }
+
+void hostPortWrite(volatile uint8_t *port, uint8_t value);	// schreiben und aufzeichnen
+void hostTraceReset(void);									// Takte und Aufzeichnung auf 0
+uint32_t hostTraceCount(void);								// Anzahl aufgezeichneter Einträge
+uint32_t hostTraceLost(void);								// wegen vollem Puffer verworfen
+const HostPortEvent *hostTraceEvents(void);
+uint64_t hostCliCycles(void);								// Takte mit gesperrten Interrupts
+uint64_t hostCliMax(void);									// längste Sperre am Stück
+
+// USART0 als SPI-Master: Byte MSB zuerst auf TXD (PORTD Bit 1) ab hostCycles
+// ausgeben, ein Bit dauert 2 * (UBRR0 + 1) Takte. Ersetzt das Schreiben von
+// UDR0; wann der Aufrufer das Byte startet (UDR-Puffer, ISR-Laufzeit),
+// modelliert er selbst (microLED, MLED_USART_SPI)
+void hostUsartSpiWrite(uint8_t data);
+
+// Messwerte eines Frames über USART0 (microLED::hostUsartStats)
+struct HostUsartStats
+{
+	uint64_t start, end;		// Takt Frame-Start, Ende des letzten Bytes
+	uint32_t bytes;				// gesendete SPI-Bytes (mit Reset-Nullen)
+	uint32_t underruns;			// Bytes, die nach dem Ende des vorigen begonnen haben
+	uint64_t gapCycles;			// Summe dieser Lücken (LOW-Verlängerung)
+	uint64_t gapMax;			// längste Lücke
+	uint64_t isrCycles;			// CPU-Takte in der UDRE-ISR
+};
+
+// Eine Zeile Messwerte seit hostTraceReset() an eine CSV-Datei anhängen
+// (Kopfzeile, wenn die Datei leer ist): Name, Pixel, Takte, Takte/Pixel,
+// Frame-µs, FPS inkl. Reset-Pause, CLI-µs gesamt, längste CLI-Sperre in µs.
+// Gezählt wird nur die Zeit des nachgebildeten asm-Codes und der Delays.
+// Rückgabe: false, wenn die Datei nicht geöffnet werden konnte
+bool hostWriteStats(const char *file, const char *name, uint16_t pixels, uint32_t resetUs = 50);
+
+// ======================== WS281x-Timingprüfung ========================
+// Grenzwerte eines Chips in ns (laut Datenblatt)
+struct HostBitTiming
+{
+	uint16_t t0hMin, t0hMax;	// HIGH-Zeit einer 0
+	uint16_t t1hMin, t1hMax;	// HIGH-Zeit einer 1
+	uint16_t tlMin, tllMax;		// LOW-Zeit zwischen zwei Bits
+	uint32_t resetMin;			// LOW-Zeit, ab der der Chip übernimmt (Latch)
+};
+
+extern const HostBitTiming hostTimingWS2811;
+extern const HostBitTiming hostTimingWS2812;
+extern const HostBitTiming hostTimingWS2813;
+extern const HostBitTiming hostTimingWS2815;
+extern const HostBitTiming hostTimingWS2818;
+extern const HostBitTiming hostTimingSK6812;
+
+// Ergebnis der Prüfung, gemessene Zeiten in CPU-Takten
+struct HostTimingReport
+{
+	uint32_t bits;				// erkannte Bits
+	uint32_t latches;			// erkannte Resets (LOW >= resetMin)
+	uint32_t errors;			// Bits außerhalb der Grenzwerte
+	uint32_t firstError;		// Index des ersten fehlerhaften Bits
+	uint32_t t0hMin, t0hMax;
+	uint32_t t1hMin, t1hMax;
+	uint32_t tlMin, tlMax;		// LOW zwischen Bits (ohne Latch)
+};
+
+// Wertet die Aufzeichnung für einen Pin (port + mask) aus. 0/1 wird an der
+// Mitte zwischen t0hMax und t1hMin unterschieden. Rückgabe: Anzahl Fehler
+uint32_t hostCheckTiming(volatile uint8_t *port, uint8_t mask,
+						 const HostBitTiming *t, HostTimingReport *rep);
+
+// Takte <-> ns bei F_CPU
+#define hostCyclesToNs(c) ((uint64_t)(c) * 1000000000ULL / F_CPU)
+
+// ======================== Frame-Dekoder ========================
+// Rekonstruiert aus der Aufzeichnung eines Pins die gesendeten LED-Farben.
+// Bits wie bei hostCheckTiming() (Schwelle zwischen t0hMax und t1hMin),
+// Bytes MSB zuerst, ein Frame endet an einem Reset (LOW >= resetMin) oder
+// am Ende der Aufzeichnung. Unvollständige Bytes/LEDs am Frame-Ende fallen weg.
+struct HostPixel
+{
+	uint8_t r, g, b, w;
+};
+
+// order: Lage von R/G/B im Datenstrom wie M_order bzw. NEO_xxx
+// ((r << 4) | (g << 2) | b, NEO zusätzlich w << 6). bpp: 3 oder 4 Bytes je LED;
+// bei 4 liegt W an Stelle (order >> 6), wenn die frei ist, sonst an Stelle 3 (microLED)
+//
+// Einen Frame (0 = erster der Aufzeichnung) nach pix dekodieren, max. maxPix LEDs.
+// Rückgabe: Anzahl LEDs im Frame, -1 wenn es den Frame nicht gibt
+int32_t hostDecodeFrame(volatile uint8_t *port, uint8_t mask, const HostBitTiming *t,
+						uint8_t order, uint8_t bpp, uint32_t frame, HostPixel *pix, uint32_t maxPix);
+
+// ======================== Frame-Log ========================
+// Binärdatei: Kopf "MLF1", danach je Frame
+//   uint16 Anzahl LEDs (little endian), uint8 bpp, LEDs * bpp Bytes R,G,B[,W]
+// Alle Frames der Aufzeichnung dekodieren und an die Datei anhängen (Kopf,
+// wenn die Datei leer ist). Rückgabe: Anzahl Frames, -1 bei Dateifehler
+int32_t hostLogFrames(const char *file, volatile uint8_t *port, uint8_t mask,
+					  const HostBitTiming *t, uint8_t order, uint8_t bpp);
+bool hostLogWrite(const char *file, const HostPixel *pix, uint16_t n, uint8_t bpp);
+// Frame Nummer frame aus der Datei lesen. Rückgabe wie hostDecodeFrame()
+int32_t hostLogRead(const char *file, uint32_t frame, HostPixel *pix, uint32_t maxPix, uint8_t *bpp = 0);
+
+// Zwei Logs Frame für Frame vergleichen, z.B. Referenzbilder der alten
+// Implementierung gegen eine optimierte Version (Golden Images)
+struct HostLogDiff
+{
+	uint32_t frames;			// verglichene Frames
+	uint32_t pixels;			// LEDs mit Abweichung > tol
+	uint32_t firstFrame;		// erste solche LED
+	uint32_t firstPixel;
+	uint8_t maxDiff;			// größte Abweichung eines Kanals
+};
+
+// tol: erlaubte Abweichung je Kanal (0 = bitgenau). Rückgabe: Anzahl LEDs
+// mit größerer Abweichung, -1 wenn eine Datei fehlt oder die Logs nicht
+// dieselbe Anzahl Frames, LEDs oder Bytes je LED haben
+int32_t hostLogCompare(const char *ref, const char *test, uint8_t tol, HostLogDiff *d);
+
+#endif
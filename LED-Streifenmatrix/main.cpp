@@ -18,13 +18,17 @@
 //#include "color.h"
 
 // Ein Byte pro Farbe global im Projekt setzen und Bibliothek laden
+// Nur bis zur letzten genderten LED senden (Lauflicht ndert wenige LEDs)
+#define MLED_PARTIAL_SHOW
 #include "microLED/microLED.h"
+#include "FrameTimer.h"
 
 
 #define SIGNAL_PIN   6	// Signalpin fr die NeoPixels
 #define LED       PINB5	// LED auf dem Board: DP 13
 //#define ZIGZAG    1	// Wechselnde Richtung der LED-Streifen
-#define DELAYVAL  50	// Periodendauer (in milliseconds)
+#define DELAYVAL  50	// Periodendauer (in milliseconds), fester Bildtakt ber Timer1
+#define BLINKVAL  30	// Leuchtdauer der Board-LED je Frame (in milliseconds)
 
 // How many NeoPixels are attached to the Arduino?
 const int ZEILEN = 30;
@@ -48,13 +52,6 @@ microLED<NUMPIXELS, SIGNAL_PIN, MLED_NO_CLOCK, LED_WS2818, ORDER_GRB, CLI_HIGH>
 	//strip.setPixelColor(ledpos, strip.Color(color.red, color.green, color.blue));
 //}
 
-void blinken()
-{
-	PORTB |= (1 << LED);	// LED an
-	_delay_ms(30.0);
-	PORTB &= ~(1 << LED);	// LED aus
-}
-
 int main(void)
 {
 	int lauf = 0;
@@ -71,13 +68,15 @@ int main(void)
 	_delay_ms(1000);
 	//digitalWrite(LED, LOW);
 	PORTB &= ~(1 << LED);	// LED aus
+	FrameTimer::statusLed(&PORTB, LED);
+	FrameTimer::begin(DELAYVAL);
 	//printf("Anzahl initialisierter LEDs: %i\n", strip.numPixels());
 	
 	//randomSeed(analogRead(0
 	//USART_init();
 	//Serial.begin();
 	_delay_ms(1000);
-	blinken();		// erstes Blinken
+	FrameTimer::blink(BLINKVAL);		// erstes Blinken
 
 	// INITIALIZE NeoPixel strip object (REQUIRED)
 	strip.setBrightness(50);
@@ -90,7 +89,7 @@ int main(void)
 	strip.show();
 	
 	_delay_ms(1000);
-	blinken();		// zweites Blinken
+	FrameTimer::blink(BLINKVAL);		// zweites Blinken
 	
 	// Zurcksetzen
 	strip.clear();
@@ -110,8 +109,9 @@ int main(void)
         // Anzeigen und pausieren fr nchsten Lauf
         //Serial.println("Zeige Matrix an");
         strip.show();   // Send the updated pixel colors to the hardware.
-        _delay_ms(DELAYVAL); // Pause before next pass through loop
-        
-		blinken();
+		FrameTimer::blink(BLINKVAL);	// LED geht in der ISR wieder aus
+		// Warten bis zum nchsten Takt; Reserve und zu lange Frames zhlt
+		// FrameTimer mit (lastIdleUs(), idlePercent(), overruns())
+		FrameTimer::waitForNextFrame();
     }
 }
\ No newline at end of file
@@ -0,0 +1,320 @@
+/*
+ * show_bench.cpp
+ * Frame-Benchmark für show() im Host-Build: 300 LEDs für jeden Chip und
+ * jeden M_ISR-Modus, dazu AdafruitMyPixel. COLOR_DEBTH und MLED_STAGE_CHUNK
+ * kommen von außen (CMake baut je Kombination ein Programm). Jede Messung
+ * hängt eine Zeile an bench_show.csv an (hostWriteStats).
+ *
+ * Gezählt werden die asm-Takte des Taktmodells und die geschätzten Takte
+ * des C-Codes zwischen den Bytes (MLED_HOST_CK_* in microLED.h).
+ *
+ * Ohne Staging zusätzlich das Abdunkeln des Puffers: fade() je Diode gegen
+ * fadeAll()/fadeRange()/nscale8() (MLED_HOST_CK_* in color_utility.cpp),
+ * showGenerated() gegen Füllen des Puffers + show() und set(x, y) auf der
+ * Matrix 10 x 30 mit Geometrie zur Laufzeit und im Template, Verlauf über
+ * 30/180/300 LEDs: getBlend je Diode gegen fillGradient (mBlend), der
+ * Durchsatz von transpose8 auf dem Host und microLEDParallel mit dem Anteil
+ * des Transponierens am Frame.
+ *
+ * Mit MLED_USART_SPI (32 MHz) nur Rendern + show() gegen showPipelined().
+ *
+ * Created: 17.10.2026 00:12:48
+ *  Author: Iggy
+ */
+#include "microLED/microLED.h"
+#include "microLED/microLEDParallel.h"
+#include "AdafruitMyPixel.h"
+#include <stdio.h>
+#include <chrono>
+
+#define BENCH_FILE		"bench_show.csv"
+#define BENCH_PIXELS	300
+
+#ifdef MLED_STAGE_CHUNK
+#define STR2(x) #x
+#define STR(x) STR2(x)
+#define BENCH_VARIANT	" stage" STR(MLED_STAGE_CHUNK)
+#else
+#define BENCH_VARIANT	""
+#endif
+
+static void report(const char *name, uint32_t resetUs, uint16_t pixels = BENCH_PIXELS)
+{
+	hostWriteStats(BENCH_FILE, name, pixels, resetUs);
+	printf("%-36s %8llu Takte %6.1f/LED  CLI max %6.1f us\n", name,
+		(unsigned long long)hostCycles, (double)hostCycles / pixels,
+		(double)hostCliMax() * 1000000.0 / F_CPU);
+}
+
+template<M_chip chip, M_ISR isr>
+static void benchMicroLED(const char *chipName, const char *isrName, uint32_t resetUs)
+{
+	static microLED<BENCH_PIXELS, 6, (chip == LED_APA102) ? 7 : MLED_NO_CLOCK, chip, ORDER_GRB, isr> strip;
+	strip.setBrightness(200);
+	for (int i = 0; i < BENCH_PIXELS; i++) strip.leds[i] = mWheel8(i);
+
+	hostTraceReset();
+	strip.show();
+
+	char name[64];
+	snprintf(name, sizeof(name), "microLED d%d %s %s%s", COLOR_DEBTH, chipName, isrName, BENCH_VARIANT);
+	report(name, resetUs);
+}
+
+template<M_chip chip>
+static void benchChip(const char *chipName, uint32_t resetUs)
+{
+	benchMicroLED<chip, CLI_OFF>(chipName, "CLI_OFF", resetUs);
+	benchMicroLED<chip, CLI_LOW>(chipName, "CLI_LOW", resetUs);
+	benchMicroLED<chip, CLI_AVER>(chipName, "CLI_AVER", resetUs);
+	benchMicroLED<chip, CLI_HIGH>(chipName, "CLI_HIGH", resetUs);
+}
+
+// Regenbogen mit mWheel8 (benchGenerated, benchPipelined). mWheel8 auf dem AVR
+// geschätzt: CALL/RET, Sektor, 2 x MUL, Rückgabe
+#define BENCH_CK_WHEEL8		40
+#define BENCH_CK_STORE		6		// Adresse + 3 x ST in leds[]
+
+#if !defined(MLED_STAGE_CHUNK) && !defined(MLED_USART_SPI)
+static void benchFade(void)
+{
+	static microLED<BENCH_PIXELS, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB, CLI_OFF> strip;
+	char name[64];
+	for (uint8_t mode = 0; mode < 4; mode++) {
+		for (int i = 0; i < BENCH_PIXELS; i++) strip.leds[i] = mWheel8(i);
+		hostTraceReset();
+		switch (mode) {
+		case 0: for (int i = 0; i < BENCH_PIXELS; i++) strip.fade(i, 32); break;
+		case 1: strip.fadeAll(32); break;
+		case 2: strip.fadeRange(0, BENCH_PIXELS / 2 - 1, 32); break;
+		case 3: nscale8(strip.leds, BENCH_PIXELS, 255 - 32); break;
+		}
+		static const char *const what[] = { "fade() je Diode", "fadeAll", "fadeRange 1/2", "nscale8" };
+		snprintf(name, sizeof(name), "microLED d%d %s", COLOR_DEBTH, what[mode]);
+		report(name, 0);
+	}
+}
+
+// einmal in leds[] und show(), einmal als Callback von showGenerated()
+static void benchGenerated(void)
+{
+	static microLED<BENCH_PIXELS, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB, CLI_OFF> strip;
+	char name[64];
+	HostTimingReport rep;
+	strip.setBrightness(200);
+
+	hostTraceReset();
+	for (int i = 0; i < BENCH_PIXELS; i++) {
+		hostTick(BENCH_CK_WHEEL8 + BENCH_CK_STORE);
+		strip.leds[i] = mWheel8(i * 4 + 10);
+	}
+	strip.show();
+	snprintf(name, sizeof(name), "microLED d%d mWheel8 in leds + show()", COLOR_DEBTH);
+	report(name, 50);
+	hostCheckTiming(&PORTD, _BV(6), &hostTimingWS2812, &rep);
+	printf("%-36s TL max %.2f us, Zeitfehler %u\n", "", hostCyclesToNs(rep.tlMax) / 1000.0, rep.errors);
+
+	hostTraceReset();
+	strip.showGenerated([](int i, int x, int y, uint16_t frame) {
+		hostTick(BENCH_CK_WHEEL8);
+		return mWheel8(i * 4 + frame);
+	}, 10);
+	snprintf(name, sizeof(name), "microLED d%d showGenerated mWheel8", COLOR_DEBTH);
+	report(name, 50);
+	hostCheckTiming(&PORTD, _BV(6), &hostTimingWS2812, &rep);
+	printf("%-36s TL max %.2f us, Zeitfehler %u\n", "", hostCyclesToNs(rep.tlMax) / 1000.0, rep.errors);
+}
+
+// set(x, y) über die ganze Matrix 10 x 30 wie LED-Streifenmatrix (Zickzack,
+// RIGHT_TOP, DIR_DOWN). Takte aus MLED_HOST_CK_SET/_SET_T; zur Kontrolle,
+// dass die Geometrie im Template wirklich zusammenfällt, die Zeit auf dem Host
+#define BENCH_MW	10
+#define BENCH_MH	30
+#define BENCH_SET_REPEAT	20000
+
+template <class S>
+static void benchSet(S &strip, const char *what)
+{
+	char name[64];
+	hostTraceReset();
+	for (int y = 0; y < BENCH_MH; y++)
+		for (int x = 0; x < BENCH_MW; x++) strip.set(x, y, mRGB(x, y, 7));
+	snprintf(name, sizeof(name), "microLED d%d set(x,y) 10x30 %s", COLOR_DEBTH, what);
+	report(name, 0);
+
+	auto t0 = std::chrono::steady_clock::now();
+	for (int r = 0; r < BENCH_SET_REPEAT; r++)
+		for (int y = 0; y < BENCH_MH; y++)
+			for (int x = 0; x < BENCH_MW; x++) strip.set(x, y, mRGB(x, y, r));
+	auto t1 = std::chrono::steady_clock::now();
+	double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+	printf("%-36s Host %.2f ns/set\n", "", ns / ((double)BENCH_SET_REPEAT * BENCH_PIXELS));
+}
+
+static void benchMatrix(void)
+{
+	static microLED<BENCH_PIXELS, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB> rt(BENCH_MW, BENCH_MH, ZIGZAG, RIGHT_TOP, DIR_DOWN);
+	static microLED<BENCH_PIXELS, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB, CLI_OFF, 0,
+					BENCH_MW, BENCH_MH, ZIGZAG, RIGHT_TOP, DIR_DOWN> tpl;
+	benchSet(rt, "Laufzeit");
+	benchSet(tpl, "Template");
+}
+
+// Verlauf zweier Farben über span LEDs: vorher getBlend je Diode (drei
+// Divisionen), jetzt fillGradient mit mBlend (Divisionen nur in begin()).
+// Nur die Farbberechnung, das Schreiben in leds[] zählt in beiden nicht
+static void benchBlend(void)
+{
+	static microLED<BENCH_PIXELS, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB> strip;
+	static const int spans[] = { 30, 180, 300 };
+	const mData c0 = mRGB(255, 20, 0), c1 = mRGB(0, 90, 255);
+	char name[64];
+	for (unsigned k = 0; k < sizeof(spans) / sizeof(spans[0]); k++) {
+		int span = spans[k];
+		hostTraceReset();
+		for (int i = 0; i < span; i++) strip.leds[i] = getBlend(i, span, c0, c1);
+		snprintf(name, sizeof(name), "microLED d%d getBlend %d LEDs", COLOR_DEBTH, span);
+		report(name, 0, span);
+
+		hostTraceReset();
+		strip.fillGradient(0, span, c0, c1);
+		snprintf(name, sizeof(name), "microLED d%d fillGradient %d LEDs", COLOR_DEBTH, span);
+		report(name, 0, span);
+	}
+}
+
+// Durchsatz von transpose8 (8 Byte aller Linien -> 8 Slots für
+// microLEDParallel) auf dem Host, die Bytes laufen durch wie in show()
+#define BENCH_TRANSPOSE_REPEAT	2000000
+
+static void benchTranspose(void)
+{
+	uint8_t in[8] = { 1, 2, 3, 4, 5, 6, 7, 8 }, out[8];
+	uint32_t sum = 0;
+	auto t0 = std::chrono::steady_clock::now();
+	for (uint32_t r = 0; r < BENCH_TRANSPOSE_REPEAT; r++) {
+		transpose8(in, out);
+		in[r & 7] ^= out[(r + 3) & 7] + 1;
+		sum += out[r & 7];
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / BENCH_TRANSPOSE_REPEAT;
+	printf("%-36s Host %.2f ns/Aufruf, %.0f MB/s (Prüfsumme %u)\n", "transpose8", ns, 8000.0 / ns, sum);
+}
+
+// microLEDParallel mit allen Linien (16 MHz 7): Frame und der Anteil der
+// Arbeit fürs Transponieren - Laden der Linien in den Pausen LOW
+// (MLED_HOST_CK_PAR_LANE) und die LSL/ROL-Paare im asm (16 Takte je Byte,
+// erstes Byte transpose8 168 + 16), dazu TL max über alle Linien
+#define BENCH_LANES		MLED_PAR_MAX_LANES
+#define BENCH_PER_LANE	(BENCH_PIXELS / BENCH_LANES)
+
+static void benchParallel(void)
+{
+	static microLEDParallel<BENCH_PER_LANE, BENCH_LANES, 0, LED_WS2812, ORDER_GRB> strip;
+	const uint16_t pixels = BENCH_PER_LANE * BENCH_LANES;
+	char name[64];
+	strip.setBrightness(200);
+	for (int i = 0; i < pixels; i++) strip.leds[i] = mWheel8(i);
+
+	hostTraceReset();
+	strip.show();
+	snprintf(name, sizeof(name), "microLEDParallel d%d WS2812 %dx%d", COLOR_DEBTH, BENCH_LANES, BENCH_PER_LANE);
+	report(name, 50, pixels);
+
+	uint32_t bytes = BENCH_PER_LANE * 3UL;
+	uint32_t load = bytes * BENCH_LANES * (MLED_HOST_CK_PAR_LANE + MLED_HOST_CK_UNPACK / 3);
+	uint32_t rol = bytes * 16 + 168 + 16;
+	uint32_t errors = 0, tlMax = 0;
+	for (uint8_t l = 0; l < BENCH_LANES; l++) {
+		HostTimingReport rep;
+		errors += hostCheckTiming(&PORTD, _BV(l), &hostTimingWS2812, &rep);
+		if (rep.tlMax > tlMax) tlMax = rep.tlMax;
+	}
+	printf("%-36s Laden %lu Takte (%.1f%%), LSL/ROL %lu Takte (%.1f%%)\n", "", (unsigned long)load,
+		100.0 * load / hostCycles, (unsigned long)rol, 100.0 * rol / hostCycles);
+	printf("%-36s TL max %.2f us, Zeitfehler %u\n", "", hostCyclesToNs(tlMax) / 1000.0, errors);
+}
+#endif
+
+#ifdef MLED_USART_SPI
+// Frame bis zum Ende der Übertragung (32 MHz, MLED_USART_SPI): erst alle
+// 300 LEDs rendern, dann show(), gegen showPipelined in Stücken zu 30 LEDs.
+// Rendern je LED wie benchGenerated: mWheel8 + Schreiben in leds[]
+#define BENCH_CHUNK	30
+
+static microLED<BENCH_PIXELS, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB> usartStrip;
+
+static void benchRender(int from, int to)
+{
+	for (int i = from; i < to; i++) {
+		hostTick(BENCH_CK_WHEEL8 + BENCH_CK_STORE);
+		usartStrip.leds[i] = mWheel8(i * 4 + 10);
+	}
+}
+
+static void benchPipelined(void)
+{
+	char name[64];
+	usartStrip.setBrightness(200);
+
+	hostTraceReset();
+	benchRender(0, BENCH_PIXELS);
+	usartStrip.show();
+	while (usartStrip.usartBusy());
+	snprintf(name, sizeof(name), "microLED d%d usart Rendern + show()", COLOR_DEBTH);
+	report(name, 50);
+	printf("%-36s %.1f fps\n", "", (double)F_CPU / hostCycles);
+
+	hostTick(F_CPU / 1000);				// Reset-Pause des ersten Frames vorbei
+	hostTraceReset();
+	usartStrip.showPipelined(benchRender, BENCH_CHUNK);
+	while (usartStrip.usartBusy());
+	snprintf(name, sizeof(name), "microLED d%d usart showPipelined", COLOR_DEBTH);
+	report(name, 50);
+	printf("%-36s %.1f fps, Unterläufe %u\n", "", (double)F_CPU / hostCycles,
+		usartStrip.hostUsartStats().underruns);
+}
+#endif
+
+#ifdef BENCH_ADAFRUIT
+static void benchAdafruit(void)
+{
+	AdafruitMyPixel strip(BENCH_PIXELS, 6, NEO_GRB + NEO_KHZ800);
+	strip.begin();
+	strip.setBrightness(200);
+	for (int i = 0; i < BENCH_PIXELS; i++) strip.setPixelColor(i, i, 255 - i, i / 2);
+
+	hostTraceReset();
+	strip.show();
+	report("AdafruitMyPixel NEO_GRB", 50);
+}
+#endif
+
+int main(void)
+{
+#ifdef MLED_USART_SPI
+	benchPipelined();
+	return 0;
+#else
+	benchChip<LED_WS2811>("WS2811", 50);
+	benchChip<LED_WS2812>("WS2812", 50);
+	benchChip<LED_WS2813>("WS2813", 280);
+	benchChip<LED_WS2815>("WS2815", 280);
+	benchChip<LED_WS2818>("WS2818", 280);	// LED-Streifenmatrix: WS2818, ORDER_GRB, CLI_HIGH
+	benchChip<LED_WS6812>("WS6812", 80);
+	benchChip<LED_APA102>("APA102", 0);
+#if !defined(MLED_STAGE_CHUNK) && !defined(MLED_USART_SPI)
+	benchFade();
+	benchGenerated();
+	benchMatrix();
+	benchBlend();
+	benchTranspose();
+	benchParallel();
+#endif
+#ifdef BENCH_ADAFRUIT
+	benchAdafruit();
+#endif
+	return 0;
+#endif
+}
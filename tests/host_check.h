@@ -0,0 +1,25 @@
+/*
+ * host_check.h
+ * Minimaler Prüfrahmen für die Host-Tests: CHECK() zählt Fehler mit Datei
+ * und Zeile, CHECK_DONE() gibt das Ergebnis aus und liefert den Exit-Code.
+ *
+ * Created: 16.10.2026 23:10:05
+ *  Author: Iggy
+ */
+#ifndef HostCheck_h
+#define HostCheck_h
+
+#include <stdio.h>
+
+static int hostCheckFails = 0;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		hostCheckFails++; \
+		printf("%s:%d: FEHLER: %s\n", __FILE__, __LINE__, #cond); \
+	} \
+} while (0)
+
+#define CHECK_DONE() (printf("%s\n", hostCheckFails ? "FEHLER" : "OK"), hostCheckFails ? 1 : 0)
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ * host_smoke.cpp
+ * Rauchtest des Host-Backends: microLED und AdafruitMyPixel senden je einen
+ * Frame, die Aufzeichnung muss die WS281x-Timings einhalten und dekodiert
+ * wieder die gesendeten Farben ergeben.
+ *
+ * Created: 16.10.2026 23:10:05
+ *  Author: Iggy
+ */
+#include "microLED/microLED.h"
+#include "AdafruitMyPixel.h"
+#include "host_check.h"
+
+// ein Frame je Chip mit demselben asm (WS2812-Familie), Timing gegen die
+// Tabelle des Chips, Rückgabe: Zeitfehler
+template <M_chip chip>
+static uint32_t smokeChip(const HostBitTiming *t, const char *name)
+{
+	microLED<30, 6, MLED_NO_CLOCK, chip, ORDER_GRB> strip;
+	strip.setBrightness(255);
+	for (int i = 0; i < 30; i++) {
+		strip.leds[i] = mWheel8(i * 8);
+		if (chip == LED_WS6812) strip.white[i] = i * 8;
+	}
+	uint8_t bpp = (chip == LED_WS6812) ? 4 : 3;
+
+	hostTraceReset();
+	strip.show();
+	CHECK(hostTraceLost() == 0);
+
+	HostTimingReport rep;
+	uint32_t errors = hostCheckTiming(&PORTD, _BV(6), t, &rep);
+	printf("%-7s T0H %u..%u T1H %u..%u TL %u..%u Takte, Fehler %u\n", name,
+		   rep.t0hMin, rep.t0hMax, rep.t1hMin, rep.t1hMax, rep.tlMin, rep.tlMax, errors);
+	CHECK(rep.bits == 30UL * 8 * bpp);
+	CHECK(rep.latches == 0);
+#if (F_CPU == 16000000UL)
+	CHECK(rep.t0hMin == 4 && rep.t0hMax == 4);		// 250 ns
+	CHECK(rep.t1hMin == 11 && rep.t1hMax == 11);	// 687 ns
+#endif
+
+	HostPixel pix[30];
+	CHECK(hostDecodeFrame(&PORTD, _BV(6), t, ORDER_GRB, bpp, 0, pix, 30) == 30);
+	for (int i = 0; i < 30; i++) {
+		mData c = strip.leds[i];
+		CHECK(pix[i].r == fade8R(c, 255) && pix[i].g == fade8G(c, 255) && pix[i].b == fade8B(c, 255));
+		if (chip == LED_WS6812) CHECK(pix[i].w == i * 8);
+	}
+	return errors;
+}
+
+static void smokeMicroLED(void)
+{
+	CHECK(smokeChip<LED_WS2812>(&hostTimingWS2812, "WS2812") == 0);
+	CHECK(smokeChip<LED_WS2813>(&hostTimingWS2813, "WS2813") == 0);
+	CHECK(smokeChip<LED_WS2815>(&hostTimingWS2815, "WS2815") == 0);
+	CHECK(smokeChip<LED_WS2818>(&hostTimingWS2818, "WS2818") == 0);
+	CHECK(smokeChip<LED_WS6812>(&hostTimingSK6812, "WS6812") == 0);
+}
+
+static void smokeAdafruit(void)
+{
+	AdafruitMyPixel strip(10, 6, NEO_GRB + NEO_KHZ800);
+	strip.begin();
+	for (int i = 0; i < 10; i++) strip.setPixelColor(i, i * 20, 255 - i * 20, i * 8);
+
+	hostTraceReset();
+	strip.show();
+
+	HostTimingReport rep;
+	CHECK(hostCheckTiming(&PORTD, _BV(6), &hostTimingWS2812, &rep) == 0);
+	CHECK(rep.bits == 10 * 24);
+
+	HostPixel pix[10];
+	CHECK(hostDecodeFrame(&PORTD, _BV(6), &hostTimingWS2812, NEO_GRB, 3, 0, pix, 10) == 10);
+	for (int i = 0; i < 10; i++) {		// Puffer RGB565: untere Bits fallen weg
+		CHECK(pix[i].r == ((i * 20) & 0xF8));
+		CHECK(pix[i].g == ((255 - i * 20) & 0xF8));
+		CHECK(pix[i].b == ((i * 8) & 0xF8));
+	}
+}
+
+int main(void)
+{
+	smokeMicroLED();
+	smokeAdafruit();
+	return CHECK_DONE();
+}
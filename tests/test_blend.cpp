@@ -0,0 +1,48 @@
+/*
+ * test_blend.cpp
+ * mBlend direkt gegen getBlend: für Verläufe von 2 bis 300 LEDs und
+ * Farbpaare (steigend, fallend, gleich, Extremwerte, zufällig) muss
+ * next() Schritt für Schritt getBlend(i, amount, c0, c1) liefern.
+ * Läuft für COLOR_DEBTH 1, 2 und 3.
+ *
+ * Created: 17.10.2026 07:05:37
+ *  Author: Iggy
+ */
+#include "microLED/microLED.h"
+#include "host_check.h"
+#include <stdlib.h>
+
+static uint32_t checkPair(mData c0, mData c1)
+{
+	uint32_t bad = 0;
+	for (int amount = 2; amount <= 300; amount += (amount < 40) ? 1 : 7) {
+		mBlend b;
+		b.begin(amount, c0, c1);
+		for (int i = 0; i < amount; i++)
+			if (b.next() != getBlend(i, amount, c0, c1)) bad++;
+	}
+	return bad;
+}
+
+int main(void)
+{
+	static const uint8_t fixed[][6] = {
+		{ 0, 0, 0, 255, 255, 255 },
+		{ 255, 255, 255, 0, 0, 0 },
+		{ 255, 0, 0, 0, 0, 255 },
+		{ 10, 200, 30, 250, 20, 180 },
+		{ 77, 77, 77, 77, 77, 77 },			// gleich
+		{ 1, 254, 128, 0, 255, 127 },		// Schritt kleiner als 1 je LED
+	};
+	uint32_t bad = 0;
+	for (unsigned k = 0; k < sizeof(fixed) / sizeof(fixed[0]); k++) {
+		const uint8_t *f = fixed[k];
+		bad += checkPair(mergeRGBraw(f[0], f[1], f[2]), mergeRGBraw(f[3], f[4], f[5]));
+	}
+	srand(11);
+	for (int k = 0; k < 40; k++)
+		bad += checkPair(mergeRGBraw(rand(), rand(), rand()), mergeRGBraw(rand(), rand(), rand()));
+	printf("COLOR_DEBTH %d: %u Abweichungen\n", COLOR_DEBTH, bad);
+	CHECK(bad == 0);
+	return CHECK_DONE();
+}
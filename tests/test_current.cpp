@@ -0,0 +1,79 @@
+/*
+ * test_current.cpp
+ * MLED_CURRENT_TRACK: nach jeder Schreiboperation (set, fill, fillGradient,
+ * fade, fadeRange, Matrixfunktionen, swap) muss die mitgeführte Kanalsumme
+ * gleich der neu gezählten Summe über den Puffer sein. Zufallsfolge mit
+ * festem Startwert. CMake baut den Test für COLOR_DEBTH 1 und 3 und mit
+ * MLED_DOUBLE_BUFFER (dann auch die Summe des vorderen Puffers).
+ *
+ * Created: 17.10.2026 01:31:06
+ *  Author: Iggy
+ */
+#include "microLED/microLED.h"
+#include "host_check.h"
+
+#define W 8
+#define H 8
+#define STEPS 20000
+
+static microLED<W * H, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB, CLI_OFF, 0, W, H, ZIGZAG, LEFT_BOTTOM, DIR_RIGHT> strip;
+
+static uint32_t seed = 12345;
+static uint16_t rnd(uint16_t n)
+{
+	seed = seed * 1103515245UL + 12345UL;
+	return (seed >> 16) % n;
+}
+
+static mData rndColor(void)
+{
+	return mRGB(rnd(256), rnd(256), rnd(256));
+}
+
+static uint32_t sumOf(const mData *buf)
+{
+	uint32_t sum = 0;
+	for (int i = 0; i < W * H; i++) sum += getR(buf[i]) + getG(buf[i]) + getB(buf[i]);
+	return sum;
+}
+
+int main(void)
+{
+	uint32_t wrong = 0;
+	for (uint32_t step = 0; step < STEPS; step++) {
+		uint8_t op = rnd(14);
+		int a = rnd(W * H), b = rnd(W * H);
+		if (b < a) { int t = a; a = b; b = t; }
+		switch (op) {
+		case 0: strip.set(a, rndColor()); break;
+		case 1: if (rnd(8) == 0) strip.fill(rndColor()); break;
+		case 2: strip.fill(a, b, rndColor()); break;
+		case 3: strip.fillGradient(a, b, rndColor(), rndColor()); break;
+		case 4: strip.fade(a, rnd(256)); break;
+		case 5: strip.fadeRange(a, b, rnd(256)); break;
+		case 6: if (rnd(8) == 0) strip.fadeAll(rnd(256)); break;
+		case 7: if (rnd(32) == 0) strip.clear(); break;
+		case 8: strip.set(rnd(W), rnd(H), rndColor()); break;
+		case 9: strip.fillRect(rnd(W) - 2, rnd(H) - 2, rnd(W), rnd(H), rndColor()); break;
+		case 10: strip.hline(rnd(W) - 2, rnd(H), rnd(W + 2), rndColor()); break;
+		case 11: strip.vline(rnd(W), rnd(H) - 2, rnd(H + 2), rndColor()); break;
+		case 12: {
+			mData row[W];
+			for (int i = 0; i < W; i++) row[i] = rndColor();
+			strip.blitRow(rnd(W) - 2, rnd(H), row, rnd(W) + 1);
+			break;
+		}
+		case 13: strip.swap(); break;
+		}
+		if (strip.hostChSum() != sumOf(strip.leds)) {
+			if (!wrong) printf("Schritt %u, Operation %u: Summe %u statt %u\n", step, op, strip.hostChSum(), sumOf(strip.leds));
+			wrong++;
+		}
+#ifdef MLED_DOUBLE_BUFFER
+		if (strip.hostChSum(true) != sumOf(strip.front)) wrong++;
+#endif
+	}
+	printf("MLED_CURRENT_TRACK d%d: %u von %u Schritten falsch\n", COLOR_DEBTH, wrong, STEPS);
+	CHECK(wrong == 0);
+	return CHECK_DONE();
+}
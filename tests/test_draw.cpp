@@ -0,0 +1,134 @@
+/*
+ * test_draw.cpp
+ * hline, vline, fillRect, blitRow und scroll direkt gegen ein einfaches
+ * Referenzbild ref[x][y] (Pixel für Pixel mit Bereichsprüfung), für alle
+ * 16 Anschlussarten: Koordinaten und Längen negativ, bis an den Rand und
+ * über die Matrix hinaus, scroll in alle vier Richtungen, diagonal und
+ * weiter als die Matrix.
+ *
+ * Created: 17.10.2026 06:41:53
+ *  Author: Iggy
+ */
+#include "microLED/microLED.h"
+#include "host_check.h"
+#include <string.h>
+
+#define W 7
+#define H 5
+#define N (W * H)
+
+typedef microLED<N, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB> Strip;
+
+static mData ref[W][H];
+static const char *what;			// aktueller Fall für die Fehlermeldung
+static int cfgNo;
+
+static const uint8_t matrixCfg[8][2] = {
+	{ LEFT_BOTTOM, DIR_RIGHT }, { LEFT_BOTTOM, DIR_UP },
+	{ LEFT_TOP, DIR_RIGHT }, { LEFT_TOP, DIR_DOWN },
+	{ RIGHT_TOP, DIR_LEFT }, { RIGHT_TOP, DIR_DOWN },
+	{ RIGHT_BOTTOM, DIR_LEFT }, { RIGHT_BOTTOM, DIR_UP },
+};
+
+static void refSet(int x, int y, mData c)
+{
+	if (x >= 0 && x < W && y >= 0 && y < H) ref[x][y] = c;
+}
+
+// eindeutiges Muster in Matrix und Referenz
+static void pattern(Strip &s)
+{
+	for (int y = 0; y < H; y++)
+		for (int x = 0; x < W; x++) {
+			ref[x][y] = mRGB(x * 30 + 1, y * 50 + 1, x + y * W + 1);
+			s.set(x, y, ref[x][y]);
+		}
+}
+
+static void compare(Strip &s)
+{
+	int bad = 0;
+	for (int y = 0; y < H; y++)
+		for (int x = 0; x < W; x++)
+			if (s.get(x, y) != ref[x][y]) bad++;
+	if (bad) printf("Anschluss %d, %s: %d Pixel abweichend\n", cfgNo, what, bad);
+	CHECK(bad == 0);
+}
+
+static const int coords[] = { -9, -3, -1, 0, 1, 3, W - 1, W, W + 4 };
+static const int lens[] = { -2, 0, 1, 2, 4, W + H + 3 };
+
+static void testLines(Strip &s)
+{
+	const mData c = mRGB(200, 100, 50);
+	for (unsigned a = 0; a < sizeof(coords) / sizeof(coords[0]); a++)
+		for (unsigned b = 0; b < sizeof(coords) / sizeof(coords[0]); b++)
+			for (unsigned l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+				int x = coords[a], y = coords[b] * H / W, len = lens[l];
+
+				pattern(s);
+				what = "hline";
+				s.hline(x, y, len, c);
+				for (int i = 0; i < len; i++) refSet(x + i, y, c);
+				compare(s);
+
+				pattern(s);
+				what = "vline";
+				s.vline(x, y, len, c);
+				for (int i = 0; i < len; i++) refSet(x, y + i, c);
+				compare(s);
+
+				pattern(s);
+				what = "fillRect";
+				int h = lens[(l + 2) % (sizeof(lens) / sizeof(lens[0]))];
+				s.fillRect(x, y, len, h, c);
+				for (int i = 0; i < len; i++)
+					for (int j = 0; j < h; j++) refSet(x + i, y + j, c);
+				compare(s);
+
+				pattern(s);
+				what = "blitRow";
+				mData row[W + H + 3];
+				for (int i = 0; i < len; i++) row[i] = mRGB(i * 9, 255 - i, 77);
+				s.blitRow(x, y, row, len);
+				for (int i = 0; i < len; i++) refSet(x + i, y, row[i]);
+				compare(s);
+			}
+}
+
+static void testScroll(Strip &s)
+{
+	static const int8_t moves[][2] = {
+		{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },	// vier Richtungen
+		{ 2, -3 }, { -3, 2 },						// diagonal
+		{ W + 2, 0 }, { 0, -(H + 1) },				// weiter als die Matrix
+		{ 0, 0 },
+	};
+	const mData fill = mRGB(9, 8, 7);
+	for (unsigned m = 0; m < sizeof(moves) / sizeof(moves[0]); m++) {
+		int dx = moves[m][0], dy = moves[m][1];
+		pattern(s);
+		mData old[W][H];
+		memcpy(old, ref, sizeof(ref));
+		for (int y = 0; y < H; y++)
+			for (int x = 0; x < W; x++) {
+				int sx = x - dx, sy = y - dy;
+				ref[x][y] = (sx >= 0 && sx < W && sy >= 0 && sy < H) ? old[sx][sy] : fill;
+			}
+		what = "scroll";
+		s.scroll(dx, dy, fill);
+		compare(s);
+	}
+}
+
+int main(void)
+{
+	for (int t = 0; t < 2; t++)
+		for (int c = 0; c < 8; c++) {
+			cfgNo = t * 8 + c;
+			Strip s(W, H, (M_type)t, (M_connection)matrixCfg[c][0], (M_dir)matrixCfg[c][1]);
+			testLines(s);
+			testScroll(s);
+		}
+	return CHECK_DONE();
+}
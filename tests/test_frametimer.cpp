@@ -0,0 +1,74 @@
+/*
+ * test_frametimer.cpp
+ * FrameTimer im Host-Modell: verpasste Perioden zählen einzeln, die
+ * Status-LED geht aus, wenn ihre Compare-Position schon vorbei ist, und
+ * idlePercent() stimmt auch nach mehr als 2^32 Timer-Takten.
+ *
+ * Created: 17.10.2026 03:12:27
+ *  Author: Iggy
+ */
+#include "FrameTimer.h"
+#include "host_check.h"
+
+#define FT_TICKS_PER_MS	(F_CPU / 64UL / 1000UL)
+#define LEDBIT 5
+
+static bool ledIsOn(void) { return PORTB & _BV(LEDBIT); }
+
+int main(void)
+{
+	hostTraceReset();
+	PORTB = 0;
+	FrameTimer::statusLed(&PORTB, LEDBIT);
+	FrameTimer::begin(10);
+	FrameTimer::waitForNextFrame();			// auf Periodenanfang
+	FrameTimer::resetStats();
+
+	// Frame von 35 ms bei 10 ms Periode: drei Ticks verpasst
+	_delay_ms(35);
+	FrameTimer::waitForNextFrame();
+	CHECK(FrameTimer::overruns() == 3);
+	FrameTimer::waitForNextFrame();			// wieder auf Periodenanfang
+	CHECK(FrameTimer::overruns() == 3);
+
+	// blink(0): Position ist "jetzt", also schon erreicht -> sofort aus
+	FrameTimer::blink(0);
+	CHECK(!ledIsOn());
+
+	// blink über genau eine Periode: tick() gibt COMPB mit Position 0
+	// frei, die mit dem Tick schon erreicht ist -> aus beim Tick, nicht
+	// eine Periode später
+	FrameTimer::blink(10);
+	CHECK(ledIsOn());
+	uint64_t tickAt = hostCycles + 10UL * FT_TICKS_PER_MS * 64;
+	FrameTimer::waitForNextFrame();
+	CHECK(!ledIsOn());
+	const HostPortEvent *ev = hostTraceEvents();
+	uint32_t n = hostTraceCount();
+	CHECK(n && ev[n - 1].port == &PORTB && ev[n - 1].cycle == tickAt);
+
+	// blink mitten in der Periode
+	_delay_ms(2);
+	FrameTimer::blink(5);
+	_delay_ms(4);
+	FrameTimer::waitForNextFrame();			// pollt bis zum Tick bei 10 ms
+	CHECK(!ledIsOn());
+	printf("LED aus nach %lu Takten\n", (unsigned long)(ev[hostTraceCount() - 1].cycle - tickAt));
+	CHECK(ev[hostTraceCount() - 1].cycle == tickAt + 7UL * FT_TICKS_PER_MS * 64);
+
+	// 70000 Frames zu 262 ms, halbe Periode Arbeit: Frames * (OCR1A + 1)
+	// und die Wartezeitsumme gehen über 32 Bit
+	FrameTimer::begin(262);
+	FrameTimer::waitForNextFrame();
+	FrameTimer::resetStats();
+	for (uint32_t i = 0; i < 70000UL; i++) {
+		_delay_ms(131);
+		FrameTimer::waitForNextFrame();
+	}
+	printf("idlePercent %u, overruns %u, lastIdleUs %u\n", FrameTimer::idlePercent(),
+		   FrameTimer::overruns(), FrameTimer::lastIdleUs());
+	CHECK(FrameTimer::idlePercent() == 49 || FrameTimer::idlePercent() == 50);
+	CHECK(FrameTimer::overruns() == 0);
+
+	return CHECK_DONE();
+}
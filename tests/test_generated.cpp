@@ -0,0 +1,87 @@
+/*
+ * test_generated.cpp
+ * showGenerated() im Host-Modell: die dekodierten Frames müssen für jede
+ * LED getPixNumber(x, y) die Farbe der Funktion an (x, y)
+ * zeigen (Matrix mit Geometrie zur Laufzeit und im Template), der Weiß-Kanal
+ * von WS6812 kommt aus dem Callback mit fünf Argumenten, und ein kurzer
+ * Callback hält die Bitzeiten und die Pause zwischen den Bytes ein.
+ *
+ * Created: 17.10.2026 06:02:14
+ *  Author: Iggy
+ */
+#include "microLED/microLED.h"
+#include "host_check.h"
+
+#define W 8
+#define H 6
+#define N (W * H)
+
+static mData coord(int i, int x, int y, uint16_t frame)
+{
+	return mRGB(x * 32, y * 40, (frame + i) & 0xFF);
+}
+
+// Frame 0 der Aufzeichnung: LED getPixNumber(x, y) muss coord(Nummer, x, y)
+// zeigen, für jedes (x, y) der Matrix
+template <class S>
+static void checkMatrix(S &s, uint16_t frame, const char *name)
+{
+	hostTraceReset();
+	s.showGenerated(coord, frame);
+	HostTimingReport rep;
+	uint32_t errors = hostCheckTiming(&PORTD, _BV(6), &hostTimingWS2812, &rep);
+	HostPixel pix[N];
+	CHECK(hostDecodeFrame(&PORTD, _BV(6), &hostTimingWS2812, ORDER_GRB, 3, 0, pix, N) == N);
+	uint32_t bad = 0;
+	for (int y = 0; y < H; y++)
+		for (int x = 0; x < W; x++) {
+			int i = s.getPixNumber(x, y);
+			mData c = coord(i, x, y, frame);
+			if (pix[i].r != getR(c) || pix[i].g != getG(c) || pix[i].b != getB(c)) bad++;
+		}
+	printf("%-10s %u LEDs abweichend, TL max %u Takte, Zeitfehler %u\n", name, bad, rep.tlMax, errors);
+	CHECK(bad == 0);
+	CHECK(errors == 0);
+}
+
+int main(void)
+{
+	// Matrix zur Laufzeit, Zickzack und parallel
+	microLED<N, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB> zz(W, H, ZIGZAG, RIGHT_TOP, DIR_DOWN);
+	microLED<N, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB> par(W, H, PARALLEL, LEFT_BOTTOM, DIR_UP);
+	zz.setBrightness(255);
+	par.setBrightness(255);
+	checkMatrix(zz, 3, "zigzag");
+	checkMatrix(par, 77, "parallel");
+
+	// Geometrie im Template
+	microLED<N, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB, CLI_OFF, 0, W, H, ZIGZAG, LEFT_TOP, DIR_RIGHT> tpl;
+	tpl.setBrightness(255);
+	checkMatrix(tpl, 200, "template");
+
+	// WS6812 ohne Puffer (amount 0): Weiß aus dem Callback
+	microLED<0, 6, MLED_NO_CLOCK, LED_WS6812, ORDER_GRB> rgbw;
+	rgbw.setBrightness(255);
+	hostTraceReset();
+	rgbw.showGenerated([](int i, int x, int y, uint16_t frame, byte &white) {
+		white = i * 10;
+		return mRGB(i * 5, 255 - i, frame);
+	}, 9, 20);
+	HostPixel pix[20];
+	CHECK(hostDecodeFrame(&PORTD, _BV(6), &hostTimingSK6812, ORDER_GRB, 4, 0, pix, 20) == 20);
+	for (int i = 0; i < 20; i++) {
+		mData c = mRGB(i * 5, 255 - i, 9);
+		CHECK(pix[i].r == getR(c) && pix[i].g == getG(c) && pix[i].b == getB(c));
+		CHECK(pix[i].w == i * 10);
+	}
+	HostTimingReport rep;
+	CHECK(hostCheckTiming(&PORTD, _BV(6), &hostTimingSK6812, &rep) == 0);
+
+	// Callback mit vier Argumenten: Weiß 0
+	hostTraceReset();
+	rgbw.showGenerated([](int i, int x, int y, uint16_t frame) { return mRGB(1, 2, 3); }, 0, 5);
+	CHECK(hostDecodeFrame(&PORTD, _BV(6), &hostTimingSK6812, ORDER_GRB, 4, 0, pix, 20) == 5);
+	for (int i = 0; i < 5; i++) CHECK(pix[i].w == 0 && pix[i].b == getB(mRGB(1, 2, 3)));
+
+	return CHECK_DONE();
+}
@@ -0,0 +1,242 @@
+/*
+ * test_golden.cpp
+ * Golden Images: Farbfunktionen, Bitmaps und Matrix-Zuordnung schreiben
+ * leds[] als Frames (hostLog) und werden bitgenau mit den eingecheckten
+ * Referenzen tests/golden/<name>.mlf verglichen (hostLogCompare).
+ *
+ *   test_golden <golden-Verzeichnis>           vergleichen, Ausgabe im
+ *                                              Arbeitsverzeichnis bleibt
+ *                                              bei Abweichung liegen
+ *   test_golden --regen <golden-Verzeichnis>   Referenzen neu schreiben
+ *
+ * Die Referenzen gelten für COLOR_DEBTH 3 (digiled_host). Neu erzeugen nur
+ * nach einer gewollten Änderung der Ausgabe: "cmake --build build --target golden"
+ *
+ * Created: 17.10.2026 04:20:36
+ *  Author: Iggy
+ */
+#include "microLED/microLED.h"
+#include "host_check.h"
+#include <stdio.h>
+#include <string.h>
+
+#define W 8
+#define H 6
+#define N (W * H)
+
+typedef microLED<N, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB> Strip;
+
+// ======================== Einträge ========================
+static void goldenGradient(const char *f)
+{
+	Strip s;
+	s.fillGradient(0, N, mRGB(255, 0, 0), mRGB(0, 0, 255));
+	s.hostLog(f);
+	s.clear();
+	s.fillGradient(5, 40, mRGB(10, 200, 30), mRGB(250, 20, 180));
+	s.hostLog(f);
+	s.clear();
+	s.fillGradient(30, 60, mRGB(255, 255, 255), mRGB(0, 0, 0));	// über das Ende, weiter bei 0
+	s.hostLog(f);
+	mGradient<4> g;
+	g.colors[0] = mRGB(255, 0, 0);
+	g.colors[1] = mRGB(0, 255, 0);
+	g.colors[2] = mRGB(0, 0, 255);
+	g.colors[3] = mRGB(255, 255, 0);
+	s.fillGradient(0, N, g);
+	s.hostLog(f);
+}
+
+static void goldenWheel(const char *f)
+{
+	Strip s;
+	for (int fr = 0; fr < 32; fr++) {		// 0..1530 ganz, Helligkeit 255..7
+		for (int i = 0; i < N; i++) s.leds[i] = mWheel((fr * N + i) % 1531, 255 - fr * 8);
+		s.hostLog(f);
+	}
+}
+
+static void goldenWheel8(const char *f)
+{
+	Strip s;
+	for (int fr = 0; fr < 16; fr++) {
+		for (int i = 0; i < N; i++) s.leds[i] = mWheel8(fr * N + i, 255 - fr * 16);
+		s.hostLog(f);
+	}
+}
+
+static void goldenHSVfast(const char *f)
+{
+	Strip s;
+	for (int fr = 0; fr < 36; fr++) {		// h über alle Frames, s und v je Frame
+		uint8_t sat = (fr % 6) * 51, val = (fr / 6) * 51;
+		for (int i = 0; i < N; i++) s.leds[i] = mHSVfast(fr * N + i, sat, val);
+		s.hostLog(f);
+	}
+}
+
+static void goldenFade(const char *f)
+{
+	Strip s;
+	for (int fr = 0; fr < 16; fr++) {
+		for (int i = 0; i < N; i++) s.leds[i] = getFade(mWheel8(i * 5), fr * 16 + (i & 15));
+		s.hostLog(f);
+	}
+}
+
+static const uint8_t bmp8[W * H] PROGMEM = {
+	0x00, 0x03, 0x1C, 0xE0, 0xFF, 0x92, 0x49, 0x24,
+	0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1C,
+	0x1C, 0x00, 0xFC, 0xFC, 0xFC, 0xFC, 0x00, 0x03,
+	0x03, 0x00, 0xFC, 0x1F, 0x1F, 0xFC, 0x00, 0xE3,
+	0xE3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+	0xFF, 0x6D, 0xB6, 0xDB, 0x12, 0x25, 0x88, 0x00,
+};
+static const uint16_t bmp16[4 * 3] PROGMEM = {
+	0xF800, 0x07E0, 0x001F, 0xFFFF,
+	0x8410, 0xFFE0, 0x07FF, 0xF81F,
+	0x0000, 0x4208, 0xC618, 0x1234,
+};
+static const uint32_t bmp32[3 * 4] PROGMEM = {
+	0xFF0000, 0x00FF00, 0x0000FF,
+	0xFFFFFF, 0x808080, 0x010203,
+	0xFFFF00, 0x00FFFF, 0xFF00FF,
+	0x123456, 0xABCDEF, 0x000000,
+};
+
+static void goldenBitmap8(const char *f)
+{
+	Strip s(W, H, ZIGZAG, LEFT_BOTTOM, DIR_RIGHT);
+	s.drawBitmap8(0, 0, bmp8, W, H);
+	s.hostLog(f);
+	s.clear();
+	s.drawBitmap8(3, 2, bmp8, W, H);		// teilweise außerhalb
+	s.hostLog(f);
+}
+
+static void goldenBitmap16(const char *f)
+{
+	Strip s(W, H, ZIGZAG, LEFT_BOTTOM, DIR_RIGHT);
+	s.clear();							// nicht gezeichnete LEDs definiert
+	s.drawBitmap16(1, 1, bmp16, 4, 3);
+	s.drawBitmap16(5, 3, bmp16, 4, 3);
+	s.hostLog(f);
+}
+
+static void goldenBitmap32(const char *f)
+{
+	Strip s(W, H, PARALLEL, RIGHT_TOP, DIR_DOWN);
+	s.clear();							// nicht gezeichnete LEDs definiert
+	s.drawBitmap32(0, 0, bmp32, 3, 4);
+	s.drawBitmap32(6, 3, bmp32, 3, 4);
+	s.hostLog(f);
+}
+
+// Alle 16 Anschlussarten, Pixel (x, y) mit eindeutiger Farbe
+static const uint8_t matrixCfg[8][2] = {
+	{ LEFT_BOTTOM, DIR_RIGHT }, { LEFT_BOTTOM, DIR_UP },
+	{ LEFT_TOP, DIR_RIGHT }, { LEFT_TOP, DIR_DOWN },
+	{ RIGHT_TOP, DIR_LEFT }, { RIGHT_TOP, DIR_DOWN },
+	{ RIGHT_BOTTOM, DIR_LEFT }, { RIGHT_BOTTOM, DIR_UP },
+};
+
+template <class S>
+static void drawCoords(S &s, const char *f)
+{
+	for (int y = 0; y < H; y++)
+		for (int x = 0; x < W; x++) s.set(x, y, mRGB(x * 32, y * 40, x + y * W));
+	s.hostLog(f);
+}
+
+static void goldenMatrix(const char *f)
+{
+	for (int t = 0; t < 2; t++)
+		for (int c = 0; c < 8; c++) {
+			Strip s(W, H, (M_type)t, (M_connection)matrixCfg[c][0], (M_dir)matrixCfg[c][1]);
+			drawCoords(s, f);
+		}
+}
+
+// Geometrie im Template: muss dieselben Frames liefern wie goldenMatrix
+template <M_type T, M_connection C, M_dir D>
+static void tplFrame(const char *f)
+{
+	microLED<N, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB, CLI_OFF, 0, W, H, T, C, D> s;
+	drawCoords(s, f);
+}
+
+template <M_type T>
+static void tplType(const char *f)
+{
+	tplFrame<T, LEFT_BOTTOM, DIR_RIGHT>(f);
+	tplFrame<T, LEFT_BOTTOM, DIR_UP>(f);
+	tplFrame<T, LEFT_TOP, DIR_RIGHT>(f);
+	tplFrame<T, LEFT_TOP, DIR_DOWN>(f);
+	tplFrame<T, RIGHT_TOP, DIR_LEFT>(f);
+	tplFrame<T, RIGHT_TOP, DIR_DOWN>(f);
+	tplFrame<T, RIGHT_BOTTOM, DIR_LEFT>(f);
+	tplFrame<T, RIGHT_BOTTOM, DIR_UP>(f);
+}
+
+static void goldenMatrixTpl(const char *f)
+{
+	tplType<ZIGZAG>(f);
+	tplType<PARALLEL>(f);
+}
+
+struct GoldenEntry
+{
+	const char *name;		// Ausgabe <name>.mlf, Referenz golden/<ref>.mlf
+	const char *ref;
+	void (*render)(const char *file);
+};
+
+static const GoldenEntry entries[] = {
+	{ "gradient", "gradient", goldenGradient },
+	{ "wheel", "wheel", goldenWheel },
+	{ "wheel8", "wheel8", goldenWheel8 },
+	{ "hsvfast", "hsvfast", goldenHSVfast },
+	{ "fade", "fade", goldenFade },
+	{ "bitmap8", "bitmap8", goldenBitmap8 },
+	{ "bitmap16", "bitmap16", goldenBitmap16 },
+	{ "bitmap32", "bitmap32", goldenBitmap32 },
+	{ "matrix", "matrix", goldenMatrix },
+	{ "matrix_tpl", "matrix", goldenMatrixTpl },
+};
+
+// ======================== Ablauf ========================
+int main(int argc, char **argv)
+{
+	bool regen = argc > 1 && !strcmp(argv[1], "--regen");
+	const char *dir = (argc > 1 + regen) ? argv[1 + regen] : "golden";
+	char out[256], ref[256];
+
+	for (unsigned e = 0; e < sizeof(entries) / sizeof(entries[0]); e++) {
+		const GoldenEntry &g = entries[e];
+		snprintf(ref, sizeof(ref), "%s/%s.mlf", dir, g.ref);
+		if (regen) {
+			if (strcmp(g.name, g.ref)) continue;	// Einträge mit fremder Referenz nur prüfen
+			remove(ref);							// hostLog hängt an
+			g.render(ref);
+			printf("%-10s neu: %s\n", g.name, ref);
+			continue;
+		}
+		snprintf(out, sizeof(out), "%s.mlf", g.name);
+		remove(out);
+		g.render(out);
+		HostLogDiff d;
+		int32_t n = hostLogCompare(ref, out, 0, &d);
+		if (n == 0) {
+			printf("%-10s OK, %u Frames\n", g.name, d.frames);
+			remove(out);
+		} else if (n < 0) {
+			printf("%-10s Referenz %s fehlt oder passt nicht (Frames/LEDs)\n", g.name, ref);
+		} else {
+			printf("%-10s %d LEDs abweichend, erste Frame %u LED %u, max. %u\n",
+				   g.name, n, d.firstFrame, d.firstPixel, d.maxDiff);
+		}
+		CHECK(n == 0);
+	}
+	if (regen) return 0;
+	return CHECK_DONE();
+}
@@ -0,0 +1,60 @@
+/*
+ * test_hsv.cpp
+ * mHSV() (Ganzzahl) gegen die frühere Float-Rechnung, alle 16M Eingaben.
+ * Läuft mit CRT_OFF, damit mRGB() die Werte unverändert speichert.
+ * Erlaubt: Abweichung höchstens 1 je Kanal.
+ *
+ * Created: 17.10.2026 00:40:17
+ *  Author: Iggy
+ */
+#include "microLED/color_utility.h"
+#include "host_check.h"
+
+// frühere mHSV() in float, Ergebnis als Bytes
+static void hsvFloat(uint8_t h, uint8_t s, uint8_t v, uint8_t *rgb)
+{
+	float r = 0, g = 0, b = 0;
+	float H = h / 255.0;
+	float S = s / 255.0;
+	float V = v / 255.0;
+
+	int i = int(H * 6);
+	float f = H * 6 - i;
+	float p = V * (1 - S);
+	float q = V * (1 - f * S);
+	float t = V * (1 - (1 - f) * S);
+
+	switch (i % 6) {
+	case 0: r = V, g = t, b = p; break;
+	case 1: r = q, g = V, b = p; break;
+	case 2: r = p, g = V, b = t; break;
+	case 3: r = p, g = q, b = V; break;
+	case 4: r = t, g = p, b = V; break;
+	case 5: r = V, g = p, b = q; break;
+	}
+	rgb[0] = (uint8_t)(r * 255.0);
+	rgb[1] = (uint8_t)(g * 255.0);
+	rgb[2] = (uint8_t)(b * 255.0);
+}
+
+int main(void)
+{
+	int maxDiff = 0;
+	uint32_t over = 0;
+	for (int h = 0; h < 256; h++)
+	for (int s = 0; s < 256; s++)
+	for (int v = 0; v < 256; v++) {
+		uint8_t ref[3];
+		hsvFloat(h, s, v, ref);
+		mData c = mHSV(h, s, v);
+		int d[3] = { getR(c) - ref[0], getG(c) - ref[1], getB(c) - ref[2] };
+		for (int k = 0; k < 3; k++) {
+			int a = (d[k] < 0) ? -d[k] : d[k];
+			if (a > maxDiff) maxDiff = a;
+			if (a > 1) over++;
+		}
+	}
+	printf("mHSV: max. Abweichung %d\n", maxDiff);
+	CHECK(over == 0);
+	return CHECK_DONE();
+}
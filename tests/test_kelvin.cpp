@@ -0,0 +1,77 @@
+/*
+ * test_kelvin.cpp
+ * mKelvin() (Tabelle + Interpolation) gegen die frühere Float-Rechnung.
+ * Läuft mit CRT_OFF, damit mRGB() die Werte unverändert speichert.
+ * Erwartet: auf den Stützstellen (Vielfache von 100 K) exakt gleich,
+ * dazwischen jeder Kanal zwischen den Werten der beiden Nachbarstützstellen.
+ *
+ * Created: 17.10.2026 01:14:52
+ *  Author: Iggy
+ */
+#include "microLED/color_utility.h"
+#include "host_check.h"
+#include <math.h>
+
+// frühere mKelvin() in float, Ergebnis als Bytes
+static void kelvinFloat(int kelvin, uint8_t *rgb)
+{
+	float tmpKelvin, tmpCalc;
+
+	kelvin = constrain(kelvin, 1000, 30000);
+	tmpKelvin = kelvin / 100;
+
+	if (tmpKelvin <= 66) rgb[0] = 255;
+	else {
+		tmpCalc = tmpKelvin - 60;
+		tmpCalc = (float)pow(tmpCalc, -0.1332047592);
+		tmpCalc *= (float)329.698727446;
+		rgb[0] = constrain(tmpCalc, 0, 255);
+	}
+
+	if (tmpKelvin <= 66) {
+		tmpCalc = (float)99.4708025861 * log(tmpKelvin) - 161.1195681661;
+		rgb[1] = constrain(tmpCalc, 0, 255);
+	} else {
+		tmpCalc = tmpKelvin - 60;
+		tmpCalc = (float)pow(tmpCalc, -0.0755148492);
+		tmpCalc *= (float)288.1221695283;
+		rgb[1] = constrain(tmpCalc, 0, 255);
+	}
+
+	if (tmpKelvin >= 66) rgb[2] = 255;
+	else if (tmpKelvin <= 19) rgb[2] = 0;
+	else {
+		tmpCalc = tmpKelvin - 10;
+		tmpCalc = (float)138.5177312231 * log(tmpCalc) - 305.0447927307;
+		rgb[2] = constrain(tmpCalc, 0, 255);
+	}
+}
+
+int main(void)
+{
+	uint32_t node = 0, between = 0;
+	for (int k = 0; k <= 31000; k++) {
+		uint8_t lo[3], hi[3];
+		kelvinFloat(k, lo);
+		kelvinFloat(k + 100, hi);
+		mData c = mKelvin(k);
+		uint8_t v[3] = { getR(c), getG(c), getB(c) };
+		for (int i = 0; i < 3; i++) {
+			if (k < 1000 || k >= 30000 || k % 100 == 0) {
+				if (v[i] != lo[i]) node++;
+			} else {
+				uint8_t a = (lo[i] < hi[i]) ? lo[i] : hi[i];
+				uint8_t b = (lo[i] < hi[i]) ? hi[i] : lo[i];
+				if (v[i] < a || v[i] > b) between++;
+			}
+		}
+	}
+	printf("mKelvin: Stützstellen falsch %u, Zwischenwerte ausserhalb %u\n", node, between);
+	CHECK(node == 0);
+	CHECK(between == 0);
+
+	// Interpolation: 1050 K liegt zwischen 1000 K und 1100 K, nicht auf 1000 K
+	mData a = mKelvin(1000), m = mKelvin(1050), b = mKelvin(1100);
+	CHECK(getG(m) > getG(a) && getG(m) < getG(b));
+	return CHECK_DONE();
+}
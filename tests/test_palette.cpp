@@ -0,0 +1,127 @@
+/*
+ * test_palette.cpp
+ * microLEDPalette im Host-Modell: Packen der Nummern (4 Bit: gerade LED
+ * in der oberen Tetrade, 8 Bit: ein Byte), fill mit Grenzen, set/get auf
+ * der Matrix, rotatePalette (auch from >= to), und show(): jede LED
+ * dekodiert zu palette[get(i)], Bitzeiten und Pausen innerhalb der
+ * Tabelle (TL max <= tllMax).
+ *
+ * Created: 17.10.2026 07:31:09
+ *  Author: Iggy
+ */
+#include "microLED/microLEDPalette.h"
+#include "host_check.h"
+#include <string.h>
+
+#define N 31					// ungerade: letzte Tetrade halb belegt
+
+static microLEDPalette<N, 4, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB> p4;
+static microLEDPalette<N, 8, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB> p8;
+
+template <class P>
+static void fillPalette(P &p)
+{
+	for (int i = 0; i < p.paletteSize; i++) p.palette[i] = mRGB(i * 16, 255 - i, i * 7);
+}
+
+// show() dekodieren, Rückgabe: Zeitfehler
+template <class P>
+static uint32_t checkShow(P &p, const char *name)
+{
+	p.setBrightness(255);
+	hostTraceReset();
+	p.show();
+	HostTimingReport rep;
+	uint32_t errors = hostCheckTiming(&PORTD, _BV(6), &hostTimingWS2812, &rep);
+	CHECK(rep.bits == N * 24UL);
+	CHECK(hostCyclesToNs(rep.tlMax) <= hostTimingWS2812.tllMax);
+	HostPixel pix[N];
+	CHECK(hostDecodeFrame(&PORTD, _BV(6), &hostTimingWS2812, ORDER_GRB, 3, 0, pix, N) == N);
+	uint32_t bad = 0;
+	for (int i = 0; i < N; i++) {
+		mData c = p.palette[p.get(i)];
+		if (pix[i].r != getR(c) || pix[i].g != getG(c) || pix[i].b != getB(c)) bad++;
+	}
+	printf("%s: %u LEDs abweichend, TL max %u Takte, Zeitfehler %u\n", name, bad, rep.tlMax, errors);
+	CHECK(bad == 0);
+	return errors;
+}
+
+static void testPacking(void)
+{
+	p4.fill(0);
+	p4.set(0, 0xA);
+	p4.set(1, 0x5);
+	p4.set(2, 0x1F);				// nur untere 4 Bit
+	CHECK(p4.idx[0] == 0xA5);
+	CHECK(p4.idx[1] == 0xF0);
+	CHECK(p4.get(0) == 0xA && p4.get(1) == 0x5 && p4.get(2) == 0xF && p4.get(3) == 0);
+	p4.set(N - 1, 0x7);				// LED 30: obere Tetrade des letzten Bytes
+	CHECK(sizeof(p4.idx) == (N + 1) / 2);
+	CHECK(p4.idx[N / 2] == 0x70);
+
+	p4.fill(0x13);
+	for (int i = 0; i < N; i++) CHECK(p4.get(i) == 0x3);
+	p4.fill(-4, 5, 9);				// Anfang begrenzt
+	p4.fill(N - 2, N + 10, 12);		// Ende begrenzt
+	for (int i = 0; i < N; i++) CHECK(p4.get(i) == ((i <= 5) ? 9 : (i >= N - 2) ? 12 : 3));
+
+	CHECK(sizeof(p8.idx) == N);
+	p8.fill(200);
+	for (int i = 0; i < N; i++) CHECK(p8.get(i) == 200);
+	p8.set(7, 255);
+	CHECK(p8.idx[7] == 255 && p8.get(6) == 200 && p8.get(8) == 200);
+}
+
+static void testRotate(void)
+{
+	fillPalette(p4);
+	mData before[16];
+	memcpy(before, p4.palette, sizeof(before));
+
+	p4.rotatePalette(2, 5);			// 3 4 5 2
+	CHECK(p4.palette[2] == before[3] && p4.palette[3] == before[4]);
+	CHECK(p4.palette[4] == before[5] && p4.palette[5] == before[2]);
+	CHECK(p4.palette[1] == before[1] && p4.palette[6] == before[6]);
+
+	memcpy(p4.palette, before, sizeof(before));
+	p4.rotatePalette(5, 2);			// from > to: unverändert
+	p4.rotatePalette(4, 4);
+	CHECK(!memcmp(p4.palette, before, sizeof(before)));
+
+	p4.rotatePalette();				// ganze Palette: 0 wandert ans Ende
+	CHECK(p4.palette[15] == before[0] && p4.palette[0] == before[1]);
+	p4.rotatePalette(14, 200);		// to auf die Palette begrenzt
+	CHECK(p4.palette[15] == before[15] && p4.palette[14] == before[0]);
+}
+
+static void testMatrix(void)
+{
+	microLEDPalette<6 * 4, 4, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB> m(6, 4, ZIGZAG, LEFT_BOTTOM, DIR_RIGHT);
+	m.fill(0);
+	m.set(5, 3, 7);
+	m.set(6, 0, 9);					// außerhalb: ignoriert
+	m.set(0, -1, 9);
+	CHECK(m.get(5, 3) == 7);
+	int ones = 0;
+	for (int i = 0; i < 24; i++) ones += (m.get(i) != 0);
+	CHECK(ones == 1);
+	CHECK(m.get(m.getPixNumber(5, 3)) == 7);
+}
+
+int main(void)
+{
+	testPacking();
+	testRotate();
+	testMatrix();
+
+	fillPalette(p4);
+	for (int i = 0; i < N; i++) p4.set(i, (i * 7) & 15);
+	CHECK(checkShow(p4, "4 Bit") == 0);
+
+	fillPalette(p8);
+	for (int i = 0; i < N; i++) p8.set(i, i * 37);
+	CHECK(checkShow(p8, "8 Bit") == 0);
+
+	return CHECK_DONE();
+}
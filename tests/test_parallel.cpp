@@ -0,0 +1,68 @@
+/*
+ * test_parallel.cpp
+ * microLEDParallel mit MLED_PAR_MAX_LANES Linien (16 MHz 7, 32 MHz 8) auf
+ * PORTD ab Pin 0 im Host-Modell: jede Linie dekodiert zu ihrem Teil von
+ * leds[], Bitzeiten und die Pause zwischen den Bits (mit Laden einer Linie)
+ * gegen hostTimingWS2812/SK6812, alle Linien ohne Zeitfehler. Als
+ * test_parallel_16_slow mit doppelt so vielen Takten je Linie wie geschätzt.
+ *
+ * Created: 17.10.2026 03:48:10
+ *  Author: Iggy
+ */
+#include "microLED/microLEDParallel.h"
+#include "host_check.h"
+
+#define N 40
+#define LANES MLED_PAR_MAX_LANES
+#define US(c) ((double)(c) * 1000000.0 / F_CPU)
+
+static microLEDParallel<N, LANES, 0, LED_WS2812, ORDER_GRB> strip;
+static microLEDParallel<N, LANES, 0, LED_WS6812, ORDER_GRB> strip4;
+
+// Zeitprüfung und Dekodierung aller Linien, Rückgabe: Fehler der Zeitprüfung
+template <class S>
+static uint32_t checkLanes(S &s, const HostBitTiming *t, uint8_t bpp, const char *name)
+{
+	uint32_t errors = 0, tlMax = 0, bad = 0;
+	for (uint8_t l = 0; l < LANES; l++) {
+		HostTimingReport rep;
+		errors += hostCheckTiming(&PORTD, _BV(l), t, &rep);
+		CHECK(rep.bits == N * 8UL * bpp);
+		CHECK(rep.latches == 0);
+		if (rep.tlMax > tlMax) tlMax = rep.tlMax;
+
+		HostPixel pix[N];
+		CHECK(hostDecodeFrame(&PORTD, _BV(l), t, ORDER_GRB, bpp, 0, pix, N) == N);
+		for (int i = 0; i < N; i++) {
+			mData c = s.leds[l * N + i];
+			if (pix[i].r != fade8R(c, 255) || pix[i].g != fade8G(c, 255) || pix[i].b != fade8B(c, 255)) bad++;
+			if (bpp == 4 && pix[i].w != fade8(s.white[l * N + i], 255)) bad++;
+		}
+	}
+	CHECK(bad == 0);
+	CHECK(hostCyclesToNs(tlMax) <= t->tllMax);
+	printf("%u MHz %-7s %u Linien: Frame %.1f us, TL max %.2f us, Zeitfehler %u\n",
+		(unsigned)(F_CPU / 1000000UL), name, LANES, US(hostCycles), US(tlMax), errors);
+	return errors;
+}
+
+int main(void)
+{
+	srand(7);
+	strip.setBrightness(255);
+	for (int i = 0; i < N * LANES; i++) strip.leds[i] = mWheel8(rand());
+	hostTraceReset();
+	strip.show();
+	CHECK(checkLanes(strip, &hostTimingWS2812, 3, "WS2812") == 0);
+
+	strip4.setBrightness(255);
+	for (int i = 0; i < N * LANES; i++) {
+		strip4.leds[i] = mWheel8(rand());
+		strip4.white[i] = rand();
+	}
+	hostTraceReset();
+	strip4.show();
+	CHECK(checkLanes(strip4, &hostTimingSK6812, 4, "SK6812") == 0);
+
+	return CHECK_DONE();
+}
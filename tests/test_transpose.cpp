@@ -0,0 +1,60 @@
+/*
+ * test_transpose.cpp
+ * transpose8 gegen die Bit-Schleife aus der Beschreibung in color_utility.h:
+ * Bit (7 - k) von in[l] muss in Bit l von out[k] landen. Alle 64 einzelnen
+ * Bits, 0x00/0xFF, Schachbrett und Zufallsmuster.
+ *
+ * Created: 17.10.2026 09:12:37
+ *  Author: Iggy
+ */
+#include "microLED/microLED.h"
+#include "host_check.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void reference(const uint8_t *in, uint8_t *out)
+{
+	memset(out, 0, 8);
+	for (uint8_t k = 0; k < 8; k++)
+		for (uint8_t l = 0; l < 8; l++)
+			if (in[l] & (1 << (7 - k))) out[k] |= 1 << l;
+}
+
+static uint32_t fails;
+
+static void check(const uint8_t *in)
+{
+	uint8_t out[8], ref[8];
+	transpose8(in, out);
+	reference(in, ref);
+	if (memcmp(out, ref, 8)) {
+		if (!fails) printf("in %02X %02X %02X %02X %02X %02X %02X %02X\n",
+			in[0], in[1], in[2], in[3], in[4], in[5], in[6], in[7]);
+		fails++;
+	}
+}
+
+int main(void)
+{
+	uint8_t in[8];
+	for (uint8_t bit = 0; bit < 64; bit++) {
+		memset(in, 0, 8);
+		in[bit / 8] = 1 << (bit % 8);
+		check(in);
+	}
+	memset(in, 0x00, 8);
+	check(in);
+	memset(in, 0xFF, 8);
+	check(in);
+	for (uint8_t l = 0; l < 8; l++) in[l] = (l & 1) ? 0x55 : 0xAA;
+	check(in);
+
+	srand(11);
+	for (uint32_t n = 0; n < 100000; n++) {
+		for (uint8_t l = 0; l < 8; l++) in[l] = rand();
+		check(in);
+	}
+	printf("transpose8: %u Abweichungen\n", fails);
+	CHECK(fails == 0);
+	return CHECK_DONE();
+}
@@ -0,0 +1,108 @@
+/*
+ * test_usart.cpp
+ * MLED_USART_SPI im Host-Modell: Ringpuffer im Hauptprogramm, ISR nur
+ * Laden + UDR0. Prüft die dekodierten Bytes, die Pause vor dem nächsten
+ * Frame (nur der Rest von MLED_USART_RESET) und gibt Unterläufe und
+ * CPU-Last der ISR aus. Kein Unterlauf, Bitzeiten und Pausen innerhalb
+ * von hostTimingWS2812. Nur 32 MHz (LGT8), bei 16 MHz bricht microLED.h
+ * mit #error ab.
+ *
+ * Created: 17.10.2026 02:05:41
+ *  Author: Iggy
+ */
+#define MLED_USART_SPI
+#include "microLED/microLED.h"
+#include "host_check.h"
+
+#define N 100
+#define US(c) ((double)(c) * 1000000.0 / F_CPU)
+
+static microLED<N, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB> strip;
+
+// Frame frame aus der Aufzeichnung gegen leds[] prüfen
+static void checkFrame(uint32_t frame)
+{
+	HostPixel pix[N];
+	CHECK(hostDecodeFrame(&PORTD, _BV(PORTD1), &hostTimingWS2812, ORDER_GRB, 3, frame, pix, N) == N);
+	uint16_t bad = 0;
+	for (int i = 0; i < N; i++) {
+		mData c = strip.leds[i];
+		if (pix[i].r != fade8R(c, 255) || pix[i].g != fade8G(c, 255) || pix[i].b != fade8B(c, 255)) bad++;
+	}
+	CHECK(bad == 0);
+}
+
+static void render(int from, int to)
+{
+	for (int i = from; i < to; i++) strip.leds[i] = mWheel8(i * 2);
+	hostTick(400);
+}
+
+static void report(const char *name)
+{
+	const HostUsartStats &st = strip.hostUsartStats();
+	double load = 100.0 * st.isrCycles / (st.end - st.start);
+	printf("%u MHz %-10s Bytes %u, Unterläufe %u, längste Lücke %.1f us, ISR-Last %.1f%%\n",
+		(unsigned)(F_CPU / 1000000UL), name, st.bytes, st.underruns, US(st.gapMax), load);
+}
+
+int main(void)
+{
+	strip.setBrightness(255);
+	for (int i = 0; i < N; i++) strip.leds[i] = mWheel8(i * 2);
+
+	// Frame 1, direkt danach Frame 2: show() wartet den Rest der Reset-Pause ab
+	hostTraceReset();
+	strip.show();
+	CHECK(hostCycles < 2000);						// show() kehrt nach dem Füllen des Rings zurück
+	while (strip.usartBusy());
+	const HostUsartStats &st = strip.hostUsartStats();
+	report("show");
+	CHECK(st.bytes == N * 12 + MLED_USART_LATCH);
+	CHECK(US(st.gapMax) < 50);						// kürzer als der Reset von WS2812
+	CHECK(st.underruns == 0);
+	CHECK(st.isrCycles * 100 < (st.end - st.start) * 70);
+	HostTimingReport rep;
+	CHECK(hostCheckTiming(&PORTD, _BV(PORTD1), &hostTimingWS2812, &rep) == 0);
+	checkFrame(0);
+
+	uint64_t end1 = st.end;
+	strip.show();
+	while (strip.usartBusy());
+	CHECK(US(strip.hostUsartStats().start - end1) < 5);	// Pause lag schon im Frame
+	checkFrame(1);
+
+	// lange nach dem Frame: show() wartet nicht mehr
+	hostTick(F_CPU / 1000);
+	uint64_t call = hostCycles;
+	strip.show();
+	CHECK(US(hostCycles - call) < 100);
+	while (strip.usartBusy());
+	checkFrame(2);
+
+	// Pipeline: Stücke zu 10 LEDs, je 400 Takte Rendern. Erst alles rendern
+	// und show(), dann showPipelined: vom Aufruf bis zum Frame-Ende schneller
+	hostTick(F_CPU / 1000);
+	call = hostCycles;
+	for (int from = 0; from < N; from += 10) render(from, from + 10);
+	strip.show();
+	while (strip.usartBusy());
+	uint64_t serial = hostCycles - call;
+	checkFrame(3);
+
+	hostTick(F_CPU / 1000);
+	call = hostCycles;
+	strip.showPipelined(render, 10);
+	while (strip.usartBusy());
+	uint64_t piped = hostCycles - call;
+	report("pipelined");
+	printf("Rendern + show() %.1f us, showPipelined %.1f us\n", US(serial), US(piped));
+	CHECK(strip.hostUsartStats().underruns == 0);
+	CHECK(piped + 9 * 400 / 2 < serial);			// mindestens die Hälfte des Renderns überdeckt
+	checkFrame(4);
+
+	// alle fünf Frames der Aufzeichnung, Pausen zwischen den Frames als Latch
+	CHECK(hostCheckTiming(&PORTD, _BV(PORTD1), &hostTimingWS2812, &rep) == 0);
+	CHECK(rep.latches == 4);
+	return CHECK_DONE();
+}
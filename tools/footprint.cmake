@@ -0,0 +1,26 @@
+# Eine Zeile Speicherbedarf an footprint.txt anhängen, ohne Shell-Befehle
+# (läuft unter Windows und Linux gleich):
+#   cmake -DAVR_SIZE=<avr-size> -DELF=<datei.elf> -DNAME=<Instanz> -DOUT=<footprint.txt> -P footprint.cmake
+# Zeile: Datum Uhrzeit Instanz text data bss (Bytes, avr-size -B)
+foreach(var AVR_SIZE ELF NAME OUT)
+	if(NOT DEFINED ${var})
+		message(FATAL_ERROR "footprint.cmake: ${var} fehlt")
+	endif()
+endforeach()
+
+execute_process(COMMAND ${AVR_SIZE} -B ${ELF}
+	OUTPUT_VARIABLE size_out
+	RESULT_VARIABLE size_res)
+if(NOT size_res EQUAL 0)
+	message(FATAL_ERROR "footprint.cmake: ${AVR_SIZE} ${ELF} fehlgeschlagen")
+endif()
+
+# zweite Zeile von avr-size -B: text data bss dec hex filename
+string(REGEX MATCH "\n[ \t]*([0-9]+)[ \t]+([0-9]+)[ \t]+([0-9]+)" line "${size_out}")
+if(NOT line)
+	message(FATAL_ERROR "footprint.cmake: Ausgabe von avr-size nicht erkannt")
+endif()
+string(TIMESTAMP now "%Y-%m-%d %H:%M")
+set(entry "${now} ${NAME} text ${CMAKE_MATCH_1} data ${CMAKE_MATCH_2} bss ${CMAKE_MATCH_3}")
+file(APPEND ${OUT} "${entry}\n")
+message(STATUS ${entry})
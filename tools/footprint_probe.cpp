@@ -0,0 +1,66 @@
+/*
+ * footprint_probe.cpp
+ * Firmware-Sonde für den Speicherbedarf (Ziel "footprint" im Host-CMake,
+ * nur mit avr-g++ und avr-size). Je Build eine Instanz, ausgewählt über
+ * die Definitionen des Builds:
+ *
+ *   PROBE_EMPTY      nur main(), Grundbedarf von Laufzeit und Startup
+ *   (keine)          microLED<300, 6, ..., WS2812, GRB>, Optionen wie
+ *                    COLOR_DEBTH, MLED_PARTIAL_SHOW, MLED_STAGE_CHUNK,
+ *                    MLED_CURRENT_TRACK, MLED_DOUBLE_BUFFER, MLED_USART_SPI
+ *                    kommen per -D dazu
+ *   PROBE_MATRIX     Matrix 10 x 30 mit Geometrie im Template, set(x, y)
+ *   PROBE_PARALLEL   microLEDParallel, 5 Linien zu 60 LEDs
+ *   PROBE_ADAFRUIT   AdafruitMyPixel mit 300 LEDs
+ *
+ * main() benutzt Füllen, Helligkeit und show(), damit der Linker die
+ * Ausgabe nicht wegwirft. Von jeder Zeile in footprint.txt den Wert von
+ * PROBE_EMPTY abziehen, dann bleibt der Anteil der Bibliothek.
+ *
+ * Created: 17.10.2026 04:55:02
+ *  Author: Iggy
+ */
+#define NUM 300
+
+#if defined(PROBE_ADAFRUIT)
+#include "AdafruitMyPixel.h"
+AdafruitMyPixel strip(NUM, 6);
+#elif defined(PROBE_PARALLEL)
+#include "microLED/microLEDParallel.h"
+microLEDParallel<NUM / 5, 5, 2, LED_WS2812, ORDER_GRB> strip;
+#elif defined(PROBE_MATRIX)
+#include "microLED/microLED.h"
+microLED<NUM, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB, CLI_OFF, 0, 10, 30, ZIGZAG, RIGHT_TOP, DIR_DOWN> strip;
+#elif !defined(PROBE_EMPTY)
+#include "microLED/microLED.h"
+microLED<NUM, 6, MLED_NO_CLOCK, LED_WS2812, ORDER_GRB> strip;
+#ifdef MLED_USART_SPI
+MLED_USART_ISR(strip)
+#endif
+#else
+#include "myarduino.h"
+#endif
+
+int main(void)
+{
+	volatile uint8_t v = 0;
+	for (;;) {
+#if defined(PROBE_ADAFRUIT)
+		strip.fill(((uint32_t)v << 16) | 0x0102);
+		strip.setBrightness(v);
+		strip.show();
+#elif defined(PROBE_MATRIX)
+		strip.set(v % 10, v % 30, mWheel8(v));
+		strip.setBrightness(v);
+		strip.show();
+#elif !defined(PROBE_EMPTY)
+		strip.fill(mWheel8(v));
+		strip.setBrightness(v);
+		strip.show();
+#ifdef MLED_USART_SPI
+		while (strip.usartBusy());
+#endif
+#endif
+		v++;
+	}
+}
@@ -0,0 +1,60 @@
+/*
+ * kelvin_table.cpp
+ * Erzeugt die PROGMEM-Tabellen für mKelvin() in color_utility.cpp aus den
+ * früheren Float-Formeln (T = kelvin / 100, Schritt 100 K). In die Tabellen
+ * kommen nur die nicht konstanten Abschnitte:
+ *   R: T = 67..300   G: T = 10..300   B: T = 20..65
+ * Ausgabe auf stdout, zum Einfügen in color_utility.cpp:
+ *   ./kelvin_table > kelvin.txt
+ *
+ * Created: 17.10.2026 01:02:33
+ *  Author: Iggy
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+
+static float clamp255(float x)
+{
+	return (x < 0) ? 0 : ((x > 255) ? 255 : x);
+}
+
+// wie die frühere mKelvin(): float-Rechnung, Nachkommastellen abgeschnitten
+uint8_t kelvinR(int t)
+{
+	if (t <= 66) return 255;
+	return clamp255((float)pow((float)(t - 60), -0.1332047592) * (float)329.698727446);
+}
+
+uint8_t kelvinG(int t)
+{
+	if (t <= 66) return clamp255((float)99.4708025861 * log((float)t) - 161.1195681661);
+	return clamp255((float)pow((float)(t - 60), -0.0755148492) * (float)288.1221695283);
+}
+
+uint8_t kelvinB(int t)
+{
+	if (t >= 66) return 255;
+	if (t <= 19) return 0;
+	return clamp255((float)138.5177312231 * log((float)(t - 10)) - 305.0447927307);
+}
+
+#ifndef KELVIN_TABLE_NO_MAIN
+static void table(const char *name, uint8_t (*f)(int), int from, int to)
+{
+	printf("static const uint8_t %s[%d] PROGMEM = {", name, to - from + 1);
+	for (int t = from; t <= to; t++) {
+		if ((t - from) % 16 == 0) printf("\n   ");
+		printf(" %u,", f(t));
+	}
+	printf("\n};\n");
+}
+
+int main(void)
+{
+	table("_kelvinR", kelvinR, 67, 300);
+	table("_kelvinG", kelvinG, 10, 300);
+	table("_kelvinB", kelvinB, 20, 65);
+	return 0;
+}
+#endif